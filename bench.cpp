@@ -0,0 +1,292 @@
+#include <string>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <functional>
+#include <new>
+#include <cstdlib>
+
+#include "./core/grammar.cpp"
+#include "./core/automata.cpp"
+#include "./core/reg_exp.cpp"
+#include "./core/lexer.cpp"
+#include "./core/parsers.cpp"
+
+
+using namespace std;
+
+
+// Cantidad de reservas de memoria (operator new) desde que empezo el programa.
+// Los reemplazos no se expanden en linea para que el compilador no empareje
+// malloc con un delete y avise de una reserva "incompatible"
+static size_t n_allocations = 0;
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE void* operator new(size_t size) {
+    ++n_allocations;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+BENCH_NOINLINE void* operator new[](size_t size) { return operator new(size); }
+BENCH_NOINLINE void operator delete(void* p) noexcept { free(p); }
+BENCH_NOINLINE void operator delete[](void* p) noexcept { free(p); }
+BENCH_NOINLINE void operator delete(void* p, size_t) noexcept { free(p); }
+BENCH_NOINLINE void operator delete[](void* p, size_t) noexcept { free(p); }
+
+
+/**
+ * Gramatica de expresiones con niveles de precedencia:
+ *      E0 -> E1 X0     X0 -> o0 E1 X0 | eps     ...
+ *      F  -> num | ( E0 )
+ * Tiene 2 * levels + 1 no terminales y es LL(1)
+ */
+Grammar exprGrammar(int levels) {
+    Symbol num("num", true), open("(", true), close(")", true);
+    Symbol F("F", false);
+    unordered_set<Symbol> terminals = {num, open, close};
+    unordered_set<Symbol> nonTerminals = {F};
+    vector<Production> productions;
+
+    vector<Symbol> E;
+    for (int i = 0; i <= levels; ++i) E.push_back(i < levels ? Symbol("E" + to_string(i), false) : F);
+    for (int i = 0; i < levels; ++i) {
+        Symbol X("X" + to_string(i), false), op("o" + to_string(i), true);
+        nonTerminals.insert(E[i]);
+        nonTerminals.insert(X);
+        terminals.insert(op);
+        productions.push_back(Production(E[i], Sentence({E[i + 1], X})));
+        productions.push_back(Production(X, Sentence({op, E[i + 1], X})));
+        productions.push_back(Production(X, Sentence()));
+    }
+    productions.push_back(Production(F, Sentence({num})));
+    productions.push_back(Production(F, Sentence({open, E[0], close})));
+    return Grammar(terminals, nonTerminals, E[0], productions);
+}
+
+
+/**
+ * Entrada valida de exprGrammar(levels) con al menos length tokens, terminada en $
+ */
+vector<Symbol> exprTokens(int levels, size_t length, mt19937& rng) {
+    Symbol num("num", true), open("(", true), close(")", true);
+    vector<Symbol> ops;
+    for (int i = 0; i < levels; ++i) ops.push_back(Symbol("o" + to_string(i), true));
+
+    vector<Symbol> tokens;
+    int depth = 0;
+    bool operand = true;
+    uniform_real_distribution<double> p(0, 1);
+    while (operand || tokens.size() < length) {
+        if (operand) {
+            if (depth < 32 && p(rng) < 0.1) {
+                tokens.push_back(open);
+                ++depth;
+            } else {
+                tokens.push_back(num);
+                operand = false;
+            }
+        } else if (depth > 0 && p(rng) < 0.2) {
+            tokens.push_back(close);
+            --depth;
+        } else {
+            tokens.push_back(ops[rng() % ops.size()]);
+            operand = true;
+        }
+    }
+    for (; depth > 0; --depth) tokens.push_back(close);
+    tokens.push_back(Symbol("$", true));
+    return tokens;
+}
+
+
+/**
+ * AFND aleatorio de n estados sobre {a, b, c, d}: una cadena 0 -> 1 -> ... -> n-1
+ * con letras al azar, lazos, saltos epsilon y un lazo con todo el alfabeto en
+ * el estado inicial (busca el patron en cualquier parte del texto)
+ */
+AFND randomNFA(int n, mt19937& rng) {
+    AFND nfa(n, {n - 1});
+    for (char c = 'a'; c <= 'd'; ++c) nfa.addTransition(0, c, 0);
+    for (int i = 0; i + 1 < n; ++i) {
+        nfa.addTransition(i, (char)('a' + rng() % 4), i + 1);
+        if (rng() % 4 == 0) nfa.addTransition(i + 1, (char)('a' + rng() % 4), i + 1);
+        if (rng() % 8 == 0) nfa.addTransition(i, '\0', i + 1);
+    }
+    return nfa;
+}
+
+string randomText(size_t length, mt19937& rng) {
+    string text(length, 'a');
+    for (char& c : text) c = (char)('a' + rng() % 4);
+    return text;
+}
+
+
+/**
+ * Resultado de un benchmark: tiempo, elementos procesados (tokens, producciones,
+ * caracteres) y reservas de memoria por operacion
+ */
+struct BenchResult {
+    string name;
+    int param;
+    size_t iterations;
+    double ns_per_op;
+    double items_per_second;
+    double bytes_per_second;
+    double allocs_per_op;
+};
+
+
+class BenchRunner {
+private:
+    double min_time;
+    string filter;
+    vector<BenchResult> results;
+
+public:
+    BenchRunner(double min_time, const string& filter) : min_time(min_time), filter(filter) {}
+
+    bool enabled(const string& name) const {
+        return filter.empty() || name.find(filter) != string::npos;
+    }
+
+    /**
+     * Repite op hasta llenar min_time segundos y guarda el promedio
+     * @param items Elementos procesados por cada llamada a op
+     * @param bytes Bytes procesados por cada llamada a op (0 si no aplica)
+     */
+    void run(const string& name, int param, size_t items, size_t bytes, const function<size_t()>& op) {
+        string full_name = name + "/" + to_string(param);
+        if (!enabled(full_name)) return;
+
+        volatile size_t sink = op();        // calentamiento (construye tablas perezosas)
+        size_t iterations = 1;
+        double seconds = 0;
+        size_t allocations = 0;
+        while (true) {
+            size_t allocations_before = n_allocations;
+            auto start = chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) sink = sink + op();
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            allocations = n_allocations - allocations_before;
+            if (seconds >= min_time || iterations >= (size_t(1) << 30)) break;
+            double scale = seconds > 0 ? 1.4 * min_time / seconds : 100;
+            iterations = (size_t)(iterations * min(max(scale, 2.0), 100.0));
+        }
+        (void)sink;
+
+        double per_op = seconds / iterations;
+        results.push_back({full_name, param, iterations, per_op * 1e9, items / per_op,
+                           bytes ? bytes / per_op : 0, (double)allocations / iterations});
+        const BenchResult& r = results.back();
+        cerr << left << setw(32) << r.name << right << setw(14) << fixed << setprecision(1) << r.ns_per_op << " ns/op"
+             << setw(14) << setprecision(3) << r.items_per_second / 1e6 << " M/s"
+             << setw(12) << setprecision(1) << r.allocs_per_op << " allocs/op\n";
+    }
+
+    void printJson(ostream& out) const {
+        out << "{\n  \"context\": {\"min_time\": " << min_time << "},\n  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const BenchResult& r = results[i];
+            out << (i ? ",\n" : "\n") << setprecision(6) << defaultfloat
+                << "    {\"name\": \"" << r.name << "\", \"param\": " << r.param
+                << ", \"iterations\": " << r.iterations
+                << ", \"ns_per_op\": " << r.ns_per_op
+                << ", \"items_per_second\": " << r.items_per_second
+                << ", \"bytes_per_second\": " << r.bytes_per_second
+                << ", \"allocs_per_op\": " << r.allocs_per_op << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+};
+
+
+class CountingListener : public ParseListener {
+public:
+    size_t events = 0;
+    void onProduction(int) override { ++events; }
+    void onShift(int, const Token&) override { ++events; }
+};
+
+
+// Micro-benchmarks del analisis de gramaticas, construccion de tablas,
+// parsing y automatas; el resumen va a stderr y el JSON a stdout
+//      bench [--json] [--min-time segundos] [--filter texto]
+int main(int argc, char const *argv[]) {
+    bool json = false;
+    double min_time = 0.2;
+    string filter;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            min_time = stod(argv[++i]);
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            cerr << "uso: bench [--json] [--min-time segundos] [--filter texto]\n";
+            return 2;
+        }
+    }
+
+    BenchRunner bench(min_time, filter);
+    mt19937 rng(12345);
+
+    // Gramaticas con N no terminales
+    for (int n : {9, 33, 129}) {
+        Grammar G = exprGrammar((n - 1) / 2);
+        size_t n_productions = G.getProductions().size();
+        vector<ContainerSet> firsts = computeFirsts(G);
+
+        bench.run("computeFirsts", n, n_productions, 0, [&] {
+            return computeFirsts(G).size();
+        });
+        bench.run("computeFollows", n, n_productions, 0, [&] {
+            return computeFollows(G, firsts).size();
+        });
+        bench.run("LL1Parser", n, n_productions, 0, [&] {
+            LL1Parser parser(G);
+            return (size_t)parser.getParsingTable().getGrammar().getProductions().size();
+        });
+    }
+
+    // Flujos de N tokens con la gramatica de 4 niveles de precedencia
+    {
+        const int levels = 4;
+        Grammar G = exprGrammar(levels);
+        LL1Parser parser(G);
+        for (int n : {1000, 16000, 256000}) {
+            vector<Symbol> input = exprTokens(levels, n, rng);
+            bench.run("LL1Parser::parse", n, input.size(), 0, [&] {
+                CountingListener listener;
+                parser.parse(input, listener);
+                return listener.events;
+            });
+        }
+    }
+
+    // AFND aleatorios de N estados y su AFD, sobre 64 KiB de texto
+    string text = randomText(64 * 1024, rng);
+    for (int n : {16, 64, 256}) {
+        AFND nfa = randomNFA(n, rng);
+        bench.run("AFND::recognize", n, text.size(), text.size(), [&] {
+            return (size_t)nfa.recognize(text);
+        });
+        AFD dfa = NFAtoDFA(nfa);
+        bench.run("AFD::recognize", n, text.size(), text.size(), [&] {
+            return (size_t)dfa.recognize(text);
+        });
+    }
+
+    if (json) bench.printJson(cout);
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include <string>
+#include <iostream>
+
+#include "./core/grammar.cpp"
+#include "./core/automata.cpp"
+#include "./core/reg_exp.cpp"
+#include "./core/lexer.cpp"
+#include "./core/parsers.cpp"
+#include "./core/ast.cpp"
+#include "./core/codegen.cpp"
+
+
+using namespace std;
+
+// Genera el front end de HULK (lexer + parser LL(1)) como codigo C++
+//      codegen [salida.cpp] [namespace]
+int main(int argc, char const *argv[]) {
+    string path = argc > 1 ? argv[1] : "hulk_frontend.cpp";
+    string name_space = argc > 2 ? argv[2] : "hulk";
+
+    try {
+        HulkSyntax syntax = hulkSyntax();
+        ParsingTable table(syntax.grammar);
+        Lexer lexer(hulkLexerRules());
+        generateFrontEnd(table, lexer, name_space, path);
+    } catch (const exception& e) {
+        cerr << e.what() << "\n";
+        return 1;
+    }
+    cout << "Generado " << path << "\n";
+    return 0;
+}
@@ -0,0 +1,641 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <stdexcept>
+#include <cstdint>
+#include <algorithm>
+
+//#include "parsers.cpp"
+
+using namespace std;
+
+
+/**
+ * Tipos de nodo del AST de HULK
+ */
+enum class AstKind : uint8_t {
+    Program,        // hijos: declaraciones y expresiones de primer nivel
+    Function,       // nombre en el token; hijos: Param..., cuerpo
+    Param,          // nombre en el token
+    Block,          // hijos: expresiones
+    Let,            // hijos: Binding..., cuerpo
+    Binding,        // nombre en el token; hijo: valor
+    If,             // hijos: condicion, rama, (condicion, rama)* de los elif, else
+    While,          // hijos: condicion, cuerpo
+    Assign,         // op = o :=; hijos: variable, valor
+    Binary,         // op en el token; hijos: izquierdo, derecho
+    Unary,          // op en el token; hijo: operando
+    Call,           // nombre en el token; hijos: argumentos
+    Variable,
+    Number,
+    String,
+    Bool
+};
+
+inline const char* astKindName(AstKind kind) {
+    static const char* names[] = {
+        "Program", "Function", "Param", "Block", "Let", "Binding", "If", "While",
+        "Assign", "Binary", "Unary", "Call", "Variable", "Number", "String", "Bool"
+    };
+    return names[(int)kind];
+}
+
+
+/**
+ * AstNode
+ *      Nodo de 24 bytes enlazado por indices de 32 bits: primer hijo y
+ *      siguiente hermano (-1 = ninguno). El texto del nodo (nombre, operador o
+ *      literal) es la posicion de su token en el fuente
+ */
+struct AstNode {
+    AstKind kind;
+    int32_t op;             // id en la SymbolTable del terminal del token
+    int32_t first_child;
+    int32_t next_sibling;
+    uint32_t offset;
+    uint32_t length;
+};
+
+
+/**
+ * Ast
+ *      Arena de nodos de un archivo: se reservan al final de un unico vector
+ *      (asignacion por incremento, sin new/delete por nodo) y se liberan
+ *      todos juntos con reset() en O(1), conservando la memoria para el
+ *      siguiente archivo
+ */
+class Ast {
+public:
+    static constexpr int32_t NONE = -1;
+
+private:
+    vector<AstNode> nodes;
+    int32_t root = NONE;
+    string_view source;
+
+    void print(ostream& out, int32_t node, int depth) const {
+        const AstNode& n = nodes[node];
+        out << string(2 * depth, ' ') << astKindName(n.kind);
+        if (n.length > 0) out << " " << text(node);
+        out << "\n";
+        for (int32_t c = n.first_child; c != NONE; c = nodes[c].next_sibling) {
+            print(out, c, depth + 1);
+        }
+    }
+
+public:
+    int32_t add(AstKind kind, int32_t op = 0, uint32_t offset = 0, uint32_t length = 0) {
+        nodes.push_back({kind, op, NONE, NONE, offset, length});
+        return (int32_t)nodes.size() - 1;
+    }
+
+    /**
+     * Vacia la arena (los nodos son triviales: no hay destructores que llamar)
+     */
+    void reset(string_view new_source = string_view()) {
+        nodes.clear();
+        root = NONE;
+        source = new_source;
+    }
+
+    void reserve(size_t n) { nodes.reserve(n); }
+
+    AstNode& operator[](int32_t i) { return nodes[i]; }
+    const AstNode& operator[](int32_t i) const { return nodes[i]; }
+    int32_t size() const { return (int32_t)nodes.size(); }
+
+    int32_t getRoot() const { return root; }
+    void setRoot(int32_t node) { root = node; }
+    string_view getSource() const { return source; }
+    string_view text(int32_t node) const { return source.substr(nodes[node].offset, nodes[node].length); }
+
+    int32_t childCount(int32_t node) const {
+        int32_t count = 0;
+        for (int32_t c = nodes[node].first_child; c != NONE; c = nodes[c].next_sibling) ++count;
+        return count;
+    }
+
+    void print(ostream& out = cout) const {
+        if (root != NONE) print(out, root, 0);
+    }
+};
+
+
+/**
+ * Accion semantica de una produccion de HULK, aplicada al reducir.
+ * Los numeros son posiciones en la parte derecha; -1 = sin usar.
+ * Las listas de la gramatica (recursivas por la derecha) se devuelven como
+ * cadenas de hermanos, asi que concatenar hijos es enlazar cadenas
+ */
+struct HulkAction {
+    enum Type : uint8_t {
+        PASS,       // el valor de children[0]
+        LIST,       // la concatenacion de children
+        NODE,       // nodo kind con el token de la posicion token e hijos children
+        TAIL,       // operacion pendiente: op en token, operando children[0], resto children[1]
+        FOLD,       // aplica las operaciones pendientes children[1] sobre children[0] (asociativo izquierda)
+        PRIMARY     // id seguido de una llamada opcional: Variable o Call
+    };
+    Type type;
+    AstKind kind;
+    int8_t token;
+    int8_t children[4];
+};
+
+
+/**
+ * Gramatica LL(1) de un subconjunto de HULK (ver https://matcom.in/hulk/):
+ * funciones, let, if/elif/else, while, bloques, llamadas, asignaciones y
+ * expresiones aritmeticas, logicas, de comparacion y de concatenacion.
+ * Los terminales se llaman como los tipos de token de hulkLexerRules().
+ * Las acciones estan alineadas con las producciones por indice
+ */
+struct HulkSyntax {
+    Grammar grammar;
+    vector<HulkAction> actions;
+};
+
+HulkSyntax hulkSyntax() {
+    typedef HulkAction A;
+    const int8_t _ = -1;
+    struct Rule {
+        const char* left;
+        const char* right;
+        HulkAction action;
+    };
+
+    static const vector<Rule> rules = {
+        {"Program", "Decls", {A::NODE, AstKind::Program, _, {0, _, _, _}}},
+        {"Decls", "Decl Decls", {A::LIST, AstKind::Program, _, {0, 1, _, _}}},
+        {"Decls", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Decl", "FuncDecl", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"Decl", "Expr ;", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+
+        {"FuncDecl", "function id ( Params ) FuncBody", {A::NODE, AstKind::Function, 1, {3, 5, _, _}}},
+        {"FuncBody", "=> Expr ;", {A::PASS, AstKind::Program, _, {1, _, _, _}}},
+        {"FuncBody", "Block", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"Params", "Param ParamsTail", {A::LIST, AstKind::Program, _, {0, 1, _, _}}},
+        {"Params", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"ParamsTail", ", Param ParamsTail", {A::LIST, AstKind::Program, _, {1, 2, _, _}}},
+        {"ParamsTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Param", "id", {A::NODE, AstKind::Param, 0, {_, _, _, _}}},
+
+        {"Block", "{ BlockItems }", {A::NODE, AstKind::Block, _, {1, _, _, _}}},
+        {"BlockItems", "Expr ; BlockItems", {A::LIST, AstKind::Program, _, {0, 2, _, _}}},
+        {"BlockItems", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+
+        {"Expr", "let Bindings in Expr", {A::NODE, AstKind::Let, _, {1, 3, _, _}}},
+        {"Expr", "if ( Expr ) Expr Elifs else Expr", {A::NODE, AstKind::If, _, {2, 4, 5, 7}}},
+        {"Expr", "while ( Expr ) Expr", {A::NODE, AstKind::While, _, {2, 4, _, _}}},
+        {"Expr", "Or AssignTail", {A::FOLD, AstKind::Program, _, {0, 1, _, _}}},
+        {"AssignTail", "= Expr", {A::TAIL, AstKind::Assign, 0, {1, _, _, _}}},
+        {"AssignTail", ":= Expr", {A::TAIL, AstKind::Assign, 0, {1, _, _, _}}},
+        {"AssignTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Bindings", "Binding BindingsTail", {A::LIST, AstKind::Program, _, {0, 1, _, _}}},
+        {"BindingsTail", ", Binding BindingsTail", {A::LIST, AstKind::Program, _, {1, 2, _, _}}},
+        {"BindingsTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Binding", "id = Expr", {A::NODE, AstKind::Binding, 0, {2, _, _, _}}},
+        {"Elifs", "elif ( Expr ) Expr Elifs", {A::LIST, AstKind::Program, _, {2, 4, 5, _}}},
+        {"Elifs", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+
+        {"Or", "And OrTail", {A::FOLD, AstKind::Program, _, {0, 1, _, _}}},
+        {"OrTail", "| And OrTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"OrTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"And", "Not AndTail", {A::FOLD, AstKind::Program, _, {0, 1, _, _}}},
+        {"AndTail", "& Not AndTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"AndTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Not", "! Not", {A::NODE, AstKind::Unary, 0, {1, _, _, _}}},
+        {"Not", "Cmp", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"Cmp", "Concat CmpTail", {A::FOLD, AstKind::Program, _, {0, 1, _, _}}},
+        {"CmpTail", "CmpOp Concat", {A::TAIL, AstKind::Binary, 0, {1, _, _, _}}},
+        {"CmpTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"CmpOp", "==", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"CmpOp", "!=", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"CmpOp", "<", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"CmpOp", ">", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"CmpOp", "<=", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"CmpOp", ">=", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"Concat", "Arith ConcatTail", {A::FOLD, AstKind::Program, _, {0, 1, _, _}}},
+        {"ConcatTail", "@ Arith ConcatTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"ConcatTail", "@@ Arith ConcatTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"ConcatTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Arith", "Term ArithTail", {A::FOLD, AstKind::Program, _, {0, 1, _, _}}},
+        {"ArithTail", "+ Term ArithTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"ArithTail", "- Term ArithTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"ArithTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Term", "Factor TermTail", {A::FOLD, AstKind::Program, _, {0, 1, _, _}}},
+        {"TermTail", "* Factor TermTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"TermTail", "/ Factor TermTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"TermTail", "% Factor TermTail", {A::TAIL, AstKind::Binary, 0, {1, 2, _, _}}},
+        {"TermTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Factor", "Unary PowTail", {A::FOLD, AstKind::Program, _, {0, 1, _, _}}},
+        {"PowTail", "^ Factor", {A::TAIL, AstKind::Binary, 0, {1, _, _, _}}},
+        {"PowTail", "** Factor", {A::TAIL, AstKind::Binary, 0, {1, _, _, _}}},
+        {"PowTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Unary", "- Unary", {A::NODE, AstKind::Unary, 0, {1, _, _, _}}},
+        {"Unary", "Primary", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+
+        {"Primary", "number", {A::NODE, AstKind::Number, 0, {_, _, _, _}}},
+        {"Primary", "string", {A::NODE, AstKind::String, 0, {_, _, _, _}}},
+        {"Primary", "true", {A::NODE, AstKind::Bool, 0, {_, _, _, _}}},
+        {"Primary", "false", {A::NODE, AstKind::Bool, 0, {_, _, _, _}}},
+        {"Primary", "( Expr )", {A::PASS, AstKind::Program, _, {1, _, _, _}}},
+        {"Primary", "Block", {A::PASS, AstKind::Program, _, {0, _, _, _}}},
+        {"Primary", "id CallTail", {A::PRIMARY, AstKind::Call, 0, {1, _, _, _}}},
+        {"CallTail", "( Args )", {A::NODE, AstKind::Call, _, {1, _, _, _}}},
+        {"CallTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"Args", "Expr ArgsTail", {A::LIST, AstKind::Program, _, {0, 1, _, _}}},
+        {"Args", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+        {"ArgsTail", ", Expr ArgsTail", {A::LIST, AstKind::Program, _, {1, 2, _, _}}},
+        {"ArgsTail", "", {A::PASS, AstKind::Program, _, {_, _, _, _}}},
+    };
+
+    unordered_set<string> nonterminal_names;
+    for (const Rule& rule : rules) nonterminal_names.insert(rule.left);
+
+    unordered_set<Symbol> terminals, nonterminals;
+    vector<Production> productions;
+    vector<HulkAction> actions;
+    for (const Rule& rule : rules) {
+        vector<Symbol> right;
+        istringstream words(rule.right);
+        string word;
+        while (words >> word) {
+            bool terminal = !nonterminal_names.count(word);
+            right.push_back(Symbol(word, terminal));
+            (terminal ? terminals : nonterminals).insert(right.back());
+        }
+        nonterminals.insert(Symbol(rule.left, false));
+        productions.push_back(Production(Symbol(rule.left, false), Sentence(right)));
+        actions.push_back(rule.action);
+    }
+
+    return {Grammar(terminals, nonterminals, Symbol("Program", false), productions), actions};
+}
+
+
+/**
+ * HulkAstBuilder
+ *      Listener que arma el AST en una arena aplicando la accion de cada
+ *      produccion al reducir. Con LL1Parser se usa a traves de ReductionOrder
+ *      (ver buildHulkAst); un parser ascendente le entrega onReduce directamente
+ */
+class HulkAstBuilder : public ParseListener {
+private:
+    // Valor de cada simbolo de la parte derecha: un nodo (o cadena de
+    // hermanos) para los no terminales, el token para los terminales
+    struct Value {
+        int32_t node;
+        Token token;
+    };
+
+    const Grammar& G;
+    const vector<HulkAction>& actions;
+    Ast& ast;
+    vector<Value> values;
+
+    /**
+     * Enlaza las cadenas de hermanos en orden y devuelve la cabeza
+     */
+    int32_t concat(const Value* right, const int8_t* positions, int count) {
+        int32_t head = Ast::NONE, last = Ast::NONE;
+        for (int i = 0; i < count && positions[i] >= 0; ++i) {
+            int32_t chain = right[positions[i]].node;
+            if (chain == Ast::NONE) continue;
+            if (head == Ast::NONE) {
+                head = chain;
+            } else {
+                // Solo se recorre una cadena si hay otra detras (la cola de
+                // una lista recursiva por la derecha no se recorre nunca)
+                while (ast[last].next_sibling != Ast::NONE) last = ast[last].next_sibling;
+                ast[last].next_sibling = chain;
+            }
+            last = chain;
+        }
+        return head;
+    }
+
+    int32_t node(AstKind kind, const Token& token) {
+        return ast.add(kind, token.kind, token.offset, token.length);
+    }
+
+    /**
+     * Las operaciones pendientes forman una cadena por next_sibling, cada
+     * una con su operando derecho como primer hijo; se aplican de izquierda
+     * a derecha acumulando el resultado como operando izquierdo
+     */
+    int32_t fold(int32_t accumulated, int32_t pending) {
+        while (pending != Ast::NONE) {
+            int32_t operation = pending;
+            int32_t operand = ast[operation].first_child;
+            pending = ast[operation].next_sibling;
+
+            if (ast[operation].kind == AstKind::Assign && ast[accumulated].kind != AstKind::Variable) {
+                throw runtime_error("Error semantico: solo se puede asignar a una variable (linea " +
+                                    to_string(lineOf(accumulated)) + ")");
+            }
+            ast[operation].first_child = accumulated;
+            ast[operation].next_sibling = Ast::NONE;
+            ast[accumulated].next_sibling = operand;
+            accumulated = operation;
+        }
+        return accumulated;
+    }
+
+    uint32_t lineOf(int32_t node) const {
+        string_view source = ast.getSource();
+        uint32_t line = 1;
+        for (uint32_t i = 0; i < ast[node].offset && i < source.size(); ++i) line += source[i] == '\n';
+        return line;
+    }
+
+public:
+    HulkAstBuilder(const Grammar& G, const vector<HulkAction>& actions, Ast& ast)
+        : G(G), actions(actions), ast(ast) {}
+
+    void onShift(int terminal, const Token& token) override {
+        values.push_back({Ast::NONE, token});
+    }
+
+    void onReduce(int p) override {
+        const HulkAction& action = actions[p];
+        const int n = G.rightSize(p);
+        const Value* right = values.data() + values.size() - n;
+        Value result = {Ast::NONE, {0, 0, 0, 0}};
+
+        switch (action.type) {
+            case HulkAction::PASS:
+                if (action.children[0] >= 0) result = right[action.children[0]];
+                break;
+            case HulkAction::LIST:
+                result.node = concat(right, action.children, 4);
+                break;
+            case HulkAction::NODE: {
+                Token token = action.token >= 0 ? right[action.token].token : Token{0, 0, 0, 0};
+                result.node = node(action.kind, token);
+                ast[result.node].first_child = concat(right, action.children, 4);
+                break;
+            }
+            case HulkAction::TAIL:
+                result.node = node(action.kind, right[action.token].token);
+                ast[result.node].first_child = right[action.children[0]].node;
+                if (action.children[1] >= 0) ast[result.node].next_sibling = right[action.children[1]].node;
+                break;
+            case HulkAction::FOLD:
+                result.node = fold(right[action.children[0]].node, right[action.children[1]].node);
+                break;
+            case HulkAction::PRIMARY: {
+                int32_t call = right[action.children[0]].node;
+                const Token& name = right[action.token].token;
+                if (call == Ast::NONE) {
+                    result.node = node(AstKind::Variable, name);
+                } else {
+                    ast[call].op = name.kind;
+                    ast[call].offset = name.offset;
+                    ast[call].length = name.length;
+                    result.node = call;
+                }
+                break;
+            }
+        }
+
+        values.resize(values.size() - n);
+        values.push_back(result);
+    }
+
+    void onAccept() override {
+        ast.setRoot(values.empty() ? Ast::NONE : values.back().node);
+        values.clear();
+    }
+};
+
+
+/**
+ * Analiza un archivo HULK y deja su AST en ast (que se vacia primero).
+ * El parser y el lexer se construyen una vez y se reutilizan entre archivos,
+ * igual que la arena
+ */
+void buildHulkAst(const LL1Parser& parser, const HulkSyntax& syntax, const Lexer& lexer,
+                  string_view source, Ast& ast) {
+    ast.reset(source);
+    HulkAstBuilder builder(syntax.grammar, syntax.actions, ast);
+    ReductionOrder bottom_up(syntax.grammar, builder);
+    LexerCursor tokens(lexer, source);
+    parser.parse(tokens, bottom_up);
+}
+
+
+/**
+ * HulkChecker
+ *      Chequeo semantico basico sobre el AST: variables usadas sin definir,
+ *      asignaciones := a variables inexistentes, funciones desconocidas,
+ *      redefinidas o llamadas con otra cantidad de argumentos.
+ *      Las variables se definen con let, como parametros o con = (visible
+ *      hasta el final del bloque o programa que la contiene); las funciones
+ *      son globales y se pueden usar antes de declararlas
+ */
+class HulkChecker {
+private:
+    const Ast& ast;
+    vector<string_view> scope;
+    vector<pair<string_view, int32_t>> functions;       // nombre, cantidad de parametros
+    vector<pair<uint32_t, string>> errors;               // offset, mensaje
+
+    static int32_t builtinArity(string_view name) {
+        static const pair<const char*, int32_t> builtins[] = {
+            {"print", 1}, {"sqrt", 1}, {"sin", 1}, {"cos", 1}, {"exp", 1},
+            {"log", 2}, {"rand", 0}, {"range", 2}
+        };
+        for (const auto& [builtin, arity] : builtins) {
+            if (name == builtin) return arity;
+        }
+        return -1;
+    }
+
+    bool defined(string_view name) const {
+        for (size_t i = scope.size(); i-- > 0; ) {
+            if (scope[i] == name) return true;
+        }
+        return name == "PI" || name == "E";
+    }
+
+    int32_t arity(string_view name) const {
+        for (const auto& [function, n] : functions) {
+            if (function == name) return n;
+        }
+        return builtinArity(name);
+    }
+
+    void error(int32_t node, const string& message) { errors.push_back({ast[node].offset, message}); }
+
+    // Trabajo pendiente del recorrido: se usa una pila explicita (como runLL1)
+    // para que un AST muy profundo, p.ej. 1 + 1 + ... + 1, no desborde la pila
+    enum class Step : uint8_t {
+        Visit,          // chequear el nodo
+        Define,         // el nombre del nodo entra al alcance
+        CheckAssign,    // el destino de := tiene que estar definido
+        Restore         // cerrar el alcance: dejar value nombres
+    };
+    struct Work {
+        Step step;
+        int32_t value;
+    };
+    vector<Work> work;
+    vector<Work> children;
+
+    // Agrega los pasos de los hijos de node (en orden) y el cierre del alcance;
+    // los hijos de tipo defines entran al alcance (Param en vez de chequearse, Binding
+    // despues de chequearse; Program = ninguno)
+    void pushChildren(int32_t node, size_t outer, AstKind defines = AstKind::Program) {
+        children.clear();
+        for (int32_t c = ast[node].first_child; c != Ast::NONE; c = ast[c].next_sibling) {
+            bool define = ast[c].kind == defines;
+            if (!(define && defines == AstKind::Param)) children.push_back({Step::Visit, c});
+            if (define) children.push_back({Step::Define, c});
+        }
+        work.push_back({Step::Restore, (int32_t)outer});
+        work.insert(work.end(), children.rbegin(), children.rend());
+    }
+
+    void visit(int32_t node) {
+        const AstNode& n = ast[node];
+        size_t outer = scope.size();
+        switch (n.kind) {
+            case AstKind::Function:
+                // Los parametros entran al alcance en orden
+                pushChildren(node, outer, AstKind::Param);
+                return;
+            case AstKind::Let:
+                // Cada binding ve los anteriores; el cuerpo los ve todos
+                pushChildren(node, outer, AstKind::Binding);
+                return;
+            case AstKind::Assign: {
+                int32_t target = n.first_child;
+                // La definicion con = dura hasta el final del bloque (sin Restore)
+                work.push_back({ast.text(node) == "=" ? Step::Define : Step::CheckAssign, target});
+                work.push_back({Step::Visit, ast[target].next_sibling});
+                return;
+            }
+            case AstKind::Variable:
+                if (!defined(ast.text(node))) {
+                    error(node, "variable no definida '" + string(ast.text(node)) + "'");
+                }
+                return;
+            case AstKind::Call: {
+                int32_t expected = arity(ast.text(node));
+                int32_t given = ast.childCount(node);
+                if (expected < 0) {
+                    error(node, "funcion no definida '" + string(ast.text(node)) + "'");
+                } else if (expected != given) {
+                    error(node, "'" + string(ast.text(node)) + "' espera " + to_string(expected) +
+                                " argumentos, recibe " + to_string(given));
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        pushChildren(node, outer);
+    }
+
+    void check(int32_t root) {
+        work.assign(1, {Step::Visit, root});
+        while (!work.empty()) {
+            Work w = work.back();
+            work.pop_back();
+            switch (w.step) {
+                case Step::Visit:
+                    visit(w.value);
+                    break;
+                case Step::Define:
+                    scope.push_back(ast.text(w.value));
+                    break;
+                case Step::CheckAssign:
+                    if (!defined(ast.text(w.value))) {
+                        error(w.value, "asignacion a la variable no definida '" + string(ast.text(w.value)) + "'");
+                    }
+                    break;
+                case Step::Restore:
+                    scope.resize((size_t)w.value);
+                    break;
+            }
+        }
+    }
+
+public:
+    HulkChecker(const Ast& ast) : ast(ast) {}
+
+    /**
+     * Diagnosticos ordenados por posicion, como "linea N: mensaje"
+     */
+    vector<string> run() {
+        scope.clear();
+        functions.clear();
+        errors.clear();
+        int32_t root = ast.getRoot();
+        if (root == Ast::NONE) return {};
+
+        for (int32_t c = ast[root].first_child; c != Ast::NONE; c = ast[c].next_sibling) {
+            if (ast[c].kind != AstKind::Function) continue;
+            string_view name = ast.text(c);
+            if (arity(name) >= 0) {
+                error(c, "funcion '" + string(name) + "' ya definida");
+                continue;
+            }
+            int32_t params = 0;
+            for (int32_t p = ast[c].first_child; p != Ast::NONE; p = ast[p].next_sibling) {
+                params += ast[p].kind == AstKind::Param;
+            }
+            functions.push_back({name, params});
+        }
+        check(root);
+
+        stable_sort(errors.begin(), errors.end(),
+                    [](const auto& x, const auto& y) { return x.first < y.first; });
+        vector<string> diagnostics;
+        string_view source = ast.getSource();
+        uint32_t line = 1;
+        size_t pos = 0;
+        for (const auto& [offset, message] : errors) {
+            for (; pos < offset; ++pos) line += source[pos] == '\n';
+            diagnostics.push_back("linea " + to_string(line) + ": " + message);
+        }
+        return diagnostics;
+    }
+};
+
+vector<string> checkHulkAst(const Ast& ast) {
+    return HulkChecker(ast).run();
+}
+
+
+
+
+
+
+
+
+
+// TEST
+// AST de HULK
+void test_HulkAst() {
+    HulkSyntax syntax = hulkSyntax();
+    LL1Parser parser(syntax.grammar);
+    Lexer lexer(hulkLexerRules());
+    Ast ast;
+
+    vector<string> programs = {
+        "x = 1;\ny = 2;\nprint(x + y);",
+        "function square(x) => x ^ 2;\n"
+        "let a = 1, b = a * 2 + 3 in if (a < b) print(square(b) @ \"!\") else { a := -a; print(a); };",
+    };
+
+    for (const string& program : programs) {
+        buildHulkAst(parser, syntax, lexer, program, ast);
+        cout << "\n=== AST ===\n" << program << "\n\n";
+        ast.print();
+        cout << ast.size() << " nodos, " << ast.size() * sizeof(AstNode) << " bytes\n";
+    }
+}
@@ -6,16 +6,63 @@
 #include <stdexcept>
 #include <queue>
 #include <utility>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <bitset>
+#include <atomic>
 
 using namespace std;
 
 
+/**
+ * LazyCache
+ *      Estructura derivada de un objeto que se construye la primera vez que
+ *      la pide un metodo const (p.ej. la simulacion de recognize). El puntero
+ *      se lee y se publica con operaciones atomicas, asi varios hilos pueden
+ *      usar el mismo automata; si dos la construyen a la vez queda cualquiera
+ *      de las dos, que son iguales
+ */
+template <class T>
+class LazyCache {
+private:
+    mutable shared_ptr<const T> value;
+
+public:
+    LazyCache() = default;
+    LazyCache(const LazyCache& other) : value(atomic_load(&other.value)) {}
+    LazyCache& operator=(const LazyCache& other) {
+        atomic_store(&value, atomic_load(&other.value));
+        return *this;
+    }
+
+    template <class Build>
+    shared_ptr<const T> get(const Build& build) const {
+        shared_ptr<const T> current = atomic_load(&value);
+        if (!current) {
+            current = build();
+            atomic_store(&value, current);
+        }
+        return current;
+    }
+
+    // Invalida la estructura (solo desde metodos no const)
+    void reset() { atomic_store(&value, shared_ptr<const T>()); }
+};
+
+
+class BitNFA;
+class DFATable;
+
 
 class AFND {
     public:
         struct Pair_Hash {
             std::size_t operator()(const pair<int,char>& p) const {
-                return hash<int>()(p.first) ^ (hash<char>()(p.second) << 1);
+                // (estado, caracter) -> entero sin colisiones
+                return hash<long long>()(((long long)p.first << 8) | (unsigned char)p.second);
             }
         };
     
@@ -24,6 +71,8 @@ class AFND {
         unordered_set<int> final_states;
         unordered_map<pair<int,char>, vector<int>, Pair_Hash> transitions;
         int start_state;
+        // Simulacion bit-paralela, se construye la primera vez que se llama a recognize
+        LazyCache<BitNFA> simulation;
 
     
     public:
@@ -49,6 +98,17 @@ class AFND {
                     validate();
                 }
         AFND(int n_states, 
+            const unordered_set<int>& final_states, 
+            unordered_map<pair<int,char>, vector<int>, Pair_Hash>&& transitions, 
+            int start_state = 0): 
+                n_states(n_states), 
+                final_states(final_states),
+                transitions(std::move(transitions)),
+                start_state(start_state) 
+                {
+                    validate();
+                }
+        AFND(int n_states, 
             const unordered_set<int>& final_states,
             int start = 0):
                 n_states(n_states),
@@ -101,6 +161,7 @@ class AFND {
         void addTransition(int from, char symbol, int to) {
             if (from < 0 || from >= n_states || to < 0 || to >= n_states) throw invalid_argument("Estados fuera del rango valido");
             transitions[{from,symbol}].push_back(to);
+            simulation.reset();
         }
         vector<int> getTransitions(int state, char symbol) const {
             auto it = transitions.find({state, symbol});
@@ -137,33 +198,10 @@ class AFND {
             return closure;
         }
 
-        bool recognize(const string& word) const {
-            unordered_set<int> currentStates = epsilonClosure({start_state});
-
-            for (char symbol : word) {
-                unordered_set<int> nextStates;
-                
-                // Para cada estado actual, encontrar todos los estados alcanzables    
-                for (int state : currentStates) {
-                    vector<int> transitions = getTransitions(state, symbol);
-                    for (int nextState : transitions) {
-                        nextStates.insert(nextState);
-                    }
-                }
-
-                currentStates = epsilonClosure(nextStates);
-                if (currentStates.empty()) {
-                    return false; // No hay estados alcanzables
-                }
-            }
-
-            for (int state : currentStates) {
-                if (final_states.find(state) != final_states.end()) {
-                    return true; // Al menos un estado final alcanzado
-                }
-            }
-            return false;
-        }
+        /*
+         * Reconoce la cadena simulando el automata con BitNFA (ver abajo)
+        */
+        bool recognize(const string& word) const;
     
         void print() const {
             cout << "AFND con " << n_states << " estados." << endl;
@@ -210,6 +248,9 @@ class AFD : public AFND {
                 }
     
     private:
+        // Tabla compilada, se construye la primera vez que se llama a recognize
+        LazyCache<DFATable> table;
+
         void validateDeterminism() {
             for (const auto& [key, dests] : getTransitions()) {
                 if (dests.size() != 1) {
@@ -227,20 +268,12 @@ class AFD : public AFND {
                 throw invalid_argument("Ya existe una transicion para el estado " + to_string(from) + " con el simbolo '" + symbol + "'");
             }
             AFND::addTransition(from, symbol, to);
+            table.reset();
         }
-        bool recognize(const string& word) const {
-            int currentState = getStartState();
-
-            for (char symbol : word) {
-                vector<int> nextStates = getTransitions(currentState, symbol);
-                if (nextStates.empty()) {
-                    return false; // No hay transiciones posibles
-                }
-                currentState = nextStates[0]; // AFD tiene una unica transicion por simbolo
-            }
-
-            return isFinalState(currentState); // Verifica si el estado final es un estado de aceptación
-        }
+        /*
+         * Reconoce la cadena recorriendo la DFATable compilada (ver abajo)
+        */
+        bool recognize(const string& word) const;
         void print() const {
             cout << "AFD con " << getNumStates() << " estados." << endl;
             cout << "Estado inicial: " << getStartState() << endl;
@@ -269,27 +302,884 @@ class AFD : public AFND {
 
 
 
+/**
+ * DFATable
+ *      Forma compilada de un AFD para recorrerlo sin hashing ni reservas:
+ *      - byte_class: los 256 bytes agrupados en clases con columnas iguales
+ *      - una matriz densa estado × clase de int16 (o int32 si no cabe) con
+ *        el siguiente estado ya multiplicado por el numero de clases (fila)
+ *      - el estado 0 es el estado muerto: todas sus transiciones vuelven a el
+ *      - los estados de aceptacion van al final, asi que aceptar es una
+ *        comparacion con first_accepting_row
+ *
+ *      Los estados se manejan como filas (estado * numero de clases)
+ */
+class DFATable {
+public:
+    static constexpr int32_t DEAD = 0;
+
+private:
+    int n_states;                   // incluye el estado muerto
+    int n_classes;
+    int32_t start_row;
+    int32_t first_accepting_row;
+    uint16_t byte_class[256];       // hasta 257 clases: la 0 y una por byte
+    bool wide;
+    vector<int16_t> next16;
+    vector<int32_t> next32;
+    vector<int32_t> labels;         // etiqueta de cada estado (0 = no acepta)
+    vector<int32_t> original;       // estado del AFD de cada estado (-1 para el muerto)
+
+    template<typename Cell>
+    bool run(const Cell* next, const unsigned char* input, size_t size) const {
+        int32_t row = start_row;
+        size_t i = 0;
+        // Desenrollado de a 4: el estado muerto es absorbente, basta revisarlo por bloque
+        for (; i + 4 <= size; i += 4) {
+            row = next[row + byte_class[input[i]]];
+            row = next[row + byte_class[input[i + 1]]];
+            row = next[row + byte_class[input[i + 2]]];
+            row = next[row + byte_class[input[i + 3]]];
+            if (row == DEAD) return false;
+        }
+        for (; i < size; ++i) {
+            row = next[row + byte_class[input[i]]];
+        }
+        return row >= first_accepting_row;
+    }
+
+public:
+    /**
+     * @param state_labels Etiqueta de cada estado del AFD (0 = no acepta); por
+     *        defecto 1 para los estados finales
+     */
+    DFATable(const AFD& dfa, const vector<int>* state_labels = nullptr) {
+        const int n = dfa.getNumStates();
+
+        vector<int> delta((size_t)n * 256, -1);
+        for (const auto& [key, dests] : dfa.getTransitions()) {
+            delta[(size_t)key.first * 256 + (unsigned char)key.second] = dests[0];
+        }
+
+        // Clases de bytes: la clase 0 es la de los bytes sin ninguna transicion
+        unordered_map<string, int> class_of_column;
+        vector<int> representative(1, -1);
+        string column((size_t)n * sizeof(int), 0);
+        n_classes = 1;
+        for (int b = 0; b < 256; ++b) {
+            bool any = false;
+            for (int st = 0; st < n; ++st) {
+                int target = delta[(size_t)st * 256 + b];
+                memcpy(&column[st * sizeof(int)], &target, sizeof(int));
+                any |= target >= 0;
+            }
+            if (!any) {
+                byte_class[b] = 0;
+                continue;
+            }
+            auto it = class_of_column.find(column);
+            if (it == class_of_column.end()) {
+                it = class_of_column.emplace(column, n_classes++).first;
+                representative.push_back(b);
+            }
+            byte_class[b] = (uint16_t)it->second;
+        }
+
+        // Orden: muerto, estados que no aceptan, estados que aceptan
+        vector<int> label(n);
+        for (int st = 0; st < n; ++st) {
+            label[st] = state_labels ? (*state_labels)[st] : (dfa.isFinalState(st) ? 1 : 0);
+        }
+        vector<int> new_state(n);
+        n_states = 1;
+        original.assign(1, -1);
+        for (int pass = 0; pass < 2; ++pass) {
+            if (pass == 1) first_accepting_row = n_states * n_classes;
+            for (int st = 0; st < n; ++st) {
+                if ((label[st] != 0) != (pass == 1)) continue;
+                new_state[st] = n_states++;
+                original.push_back(st);
+            }
+        }
+        labels.assign(n_states, 0);
+        for (int st = 0; st < n; ++st) labels[new_state[st]] = label[st];
+
+        vector<int32_t> next((size_t)n_states * n_classes, DEAD);
+        for (int st = 0; st < n; ++st) {
+            for (int c = 1; c < n_classes; ++c) {
+                int target = delta[(size_t)st * 256 + representative[c]];
+                if (target >= 0) next[(size_t)new_state[st] * n_classes + c] = new_state[target] * n_classes;
+            }
+        }
+        start_row = new_state[dfa.getStartState()] * n_classes;
+
+        wide = (size_t)n_states * n_classes > INT16_MAX;
+        if (wide) {
+            next32 = move(next);
+        } else {
+            next16.assign(next.begin(), next.end());
+        }
+    }
+
+    bool recognize(const char* data, size_t size) const {
+        const unsigned char* input = (const unsigned char*)data;
+        return wide ? run(next32.data(), input, size) : run(next16.data(), input, size);
+    }
+
+    bool recognize(const string& word) const { return recognize(word.data(), word.size()); }
+
+    // Recorrido paso a paso (para el lexer)
+    int32_t startRow() const { return start_row; }
+    int32_t step(int32_t row, unsigned char byte) const {
+        int32_t i = row + byte_class[byte];
+        return wide ? next32[i] : next16[i];
+    }
+    bool isAccepting(int32_t row) const { return row >= first_accepting_row; }
+    int label(int32_t row) const { return labels[row / n_classes]; }
+    int originalState(int32_t row) const { return original[row / n_classes]; }
+
+    int getNumStates() const { return n_states; }
+    int getNumClasses() const { return n_classes; }
+    const uint16_t* getByteClasses() const { return byte_class; }
+    bool isWide() const { return wide; }
+    const int16_t* cells16() const { return next16.data(); }
+    const int32_t* cells32() const { return next32.data(); }
+};
+
+bool AFD::recognize(const string& word) const {
+    return table.get([this] { return make_shared<const DFATable>(*this); })->recognize(word);
+}
+
+
 /*
-function get-move(NFA, states, symbol) -> set
+ * Epsilon-clausura de cada estado como bitset: la del estado s ocupa las
+ * palabras [s * W, (s + 1) * W) con W = (n_states + 63) / 64
 */
+vector<uint64_t> epsilonClosureBitsets(const AFND& nfa) {
+    const int n = nfa.getNumStates();
+    const int W = (n + 63) / 64;
+
+    vector<vector<int>> eps(n);
+    for (const auto& [key, dests] : nfa.getTransitions()) {
+        if (key.second == '\0') {
+            eps[key.first].insert(eps[key.first].end(), dests.begin(), dests.end());
+        }
+    }
+
+    vector<uint64_t> closure((size_t)n * W, 0);
+    vector<int> pending;
+    for (int s = 0; s < n; ++s) {
+        uint64_t* c = &closure[(size_t)s * W];
+        c[s >> 6] |= uint64_t(1) << (s & 63);
+        pending.assign(1, s);
+        while (!pending.empty()) {
+            int u = pending.back();
+            pending.pop_back();
+            for (int v : eps[u]) {
+                if (!((c[v >> 6] >> (v & 63)) & 1)) {
+                    c[v >> 6] |= uint64_t(1) << (v & 63);
+                    pending.push_back(v);
+                }
+            }
+        }
+    }
+    return closure;
+}
+
+
+/**
+ * BitNFA
+ *      Simulacion de un AFND sin reservar memoria por caracter de entrada.
+ *
+ *      - Los conjuntos de estados son bitsets de ancho fijo (n_words palabras)
+ *      - La epsilon-clausura de cada estado se precalcula una vez como bitset
+ *      - Los caracteres con el mismo comportamiento se agrupan en clases, y para
+ *        cada (clase, estado) se guarda la clausura de sus destinos; las mascaras
+ *        de una misma clase quedan contiguas en memoria
+ *
+ *      Si el automata tiene a lo sumo 64 estados y a cada estado solo se llega
+ *      por una clase de caracter (como en la construccion de Thompson), se usa
+ *      el modo shift-and: un paso es alcance(D) & B[clase] seguido de la
+ *      clausura, ambos resueltos con tablas por bytes del conjunto de estados
+ */
+class BitNFA {
+private:
+    int n_states;
+    int n_words;
+    int n_classes;
+    uint8_t byte_class[256];            // caracter -> clase (0 = sin transiciones)
+    vector<uint64_t> start;             // clausura del estado inicial
+    vector<uint64_t> finals;
+    vector<int32_t> succ_offset;        // clase * n_states + estado -> inicio en succ_masks (-1 si no hay)
+    vector<uint64_t> succ_masks;
+
+    // Modo shift-and (n_states <= 64)
+    bool shift_and;
+    int n_chunks;
+    vector<uint64_t> reach_table;       // [chunk][byte] -> destinos sin clausura
+    vector<uint64_t> closure_table;     // [chunk][byte] -> epsilon-clausura
+    vector<uint64_t> class_mask;        // [clase] -> estados a los que se llega con esa clase
+
+    static void setBit(uint64_t* set, int bit) { set[bit >> 6] |= uint64_t(1) << (bit & 63); }
+
+public:
+    BitNFA(const AFND& nfa)
+        : n_states(nfa.getNumStates()), n_words((nfa.getNumStates() + 63) / 64),
+          n_classes(1), shift_and(false), n_chunks(0) {
+        const int n = n_states;
+        const int W = n_words;
+
+        // Transiciones por caracter de cada estado
+        vector<vector<pair<unsigned char,int>>> moves(n);
+        for (const auto& [key, dests] : nfa.getTransitions()) {
+            if (key.second == '\0') continue;
+            for (int to : dests) {
+                moves[key.first].push_back({(unsigned char)key.second, to});
+            }
+        }
+
+        // Epsilon-clausura de cada estado
+        vector<uint64_t> closure = epsilonClosureBitsets(nfa);
+
+        // Clases de caracteres: caracteres con la misma columna de transiciones
+        vector<vector<int>> column(n);
+        unordered_map<string, int> class_of_column;
+        vector<unsigned char> representative(1, 0);
+        memset(byte_class, 0, sizeof(byte_class));
+        for (int ch = 1; ch < 256; ++ch) {
+            string key;
+            for (int s = 0; s < n; ++s) {
+                column[s].clear();
+                for (const auto& m : moves[s]) {
+                    if (m.first == ch) column[s].push_back(m.second);
+                }
+                if (column[s].empty()) continue;
+                sort(column[s].begin(), column[s].end());
+                key += to_string(s) + ":";
+                for (int t : column[s]) key += to_string(t) + ",";
+                key += ";";
+            }
+            if (key.empty()) continue;
+            auto it = class_of_column.find(key);
+            if (it == class_of_column.end()) {
+                it = class_of_column.emplace(key, n_classes++).first;
+                representative.push_back((unsigned char)ch);
+            }
+            byte_class[ch] = (uint8_t)it->second;
+        }
+
+        // Mascaras de sucesores (ya clausuradas), agrupadas por clase
+        succ_offset.assign((size_t)n_classes * n, -1);
+        for (int c = 1; c < n_classes; ++c) {
+            for (int s = 0; s < n; ++s) {
+                bool any = false;
+                for (const auto& m : moves[s]) {
+                    if (m.first != representative[c]) continue;
+                    if (!any) {
+                        succ_offset[(size_t)c * n + s] = (int32_t)succ_masks.size();
+                        succ_masks.resize(succ_masks.size() + W, 0);
+                        any = true;
+                    }
+                    uint64_t* mask = &succ_masks[succ_offset[(size_t)c * n + s]];
+                    const uint64_t* cl = &closure[(size_t)m.second * W];
+                    for (int w = 0; w < W; ++w) mask[w] |= cl[w];
+                }
+            }
+        }
+
+        start.assign(closure.begin() + (size_t)nfa.getStartState() * W,
+                     closure.begin() + (size_t)(nfa.getStartState() + 1) * W);
+        finals.assign(W, 0);
+        for (int f : nfa.getFinalStates()) setBit(finals.data(), f);
+
+        // Modo shift-and: a cada estado se llega por una sola clase
+        if (n == 0 || n > 64) return;
+        vector<int> in_class(n, 0);
+        for (int s = 0; s < n; ++s) {
+            for (const auto& m : moves[s]) {
+                int c = byte_class[m.first];
+                if (in_class[m.second] != 0 && in_class[m.second] != c) return;
+                in_class[m.second] = c;
+            }
+        }
+        shift_and = true;
+        n_chunks = (n + 7) / 8;
+        reach_table.assign((size_t)n_chunks * 256, 0);
+        closure_table.assign((size_t)n_chunks * 256, 0);
+        class_mask.assign(n_classes, 0);
+        for (int s = 0; s < n; ++s) {
+            if (in_class[s] != 0) class_mask[in_class[s]] |= uint64_t(1) << s;
+        }
+        for (int k = 0; k < n_chunks; ++k) {
+            for (int v = 0; v < 256; ++v) {
+                uint64_t reach = 0, cl = 0;
+                for (int b = 0; b < 8; ++b) {
+                    int s = k * 8 + b;
+                    if (!((v >> b) & 1) || s >= n) continue;
+                    for (const auto& m : moves[s]) reach |= uint64_t(1) << m.second;
+                    cl |= closure[s];
+                }
+                reach_table[k * 256 + v] = reach;
+                closure_table[k * 256 + v] = cl;
+            }
+        }
+    }
+
+    bool recognize(const char* data, size_t size) const {
+        const unsigned char* input = (const unsigned char*)data;
+
+        if (shift_and) {
+            uint64_t D = start[0];
+            for (size_t i = 0; i < size; ++i) {
+                int c = byte_class[input[i]];
+                uint64_t reach = 0;
+                for (int k = 0; k < n_chunks; ++k) {
+                    reach |= reach_table[k * 256 + ((D >> (8 * k)) & 0xFF)];
+                }
+                reach &= class_mask[c];
+                D = 0;
+                for (int k = 0; k < n_chunks; ++k) {
+                    D |= closure_table[k * 256 + ((reach >> (8 * k)) & 0xFF)];
+                }
+                if (D == 0) return false;
+            }
+            return (D & finals[0]) != 0;
+        }
+
+        const int W = n_words;
+        const int n = n_states;
+        // Dos bitsets que se alternan; el unico espacio reservado por llamada
+        uint64_t local[2 * 16];
+        vector<uint64_t> heap;
+        uint64_t* current = local;
+        if (W > 16) {
+            heap.resize(2 * (size_t)W);
+            current = heap.data();
+        }
+        uint64_t* next = current + W;
+        copy(start.begin(), start.end(), current);
+
+        for (size_t i = 0; i < size; ++i) {
+            int c = byte_class[input[i]];
+            if (c == 0) return false;
+            const int32_t* offsets = &succ_offset[(size_t)c * n];
+            fill(next, next + W, 0);
+            uint64_t any = 0;
+            for (int w = 0; w < W; ++w) {
+                for (uint64_t bits = current[w]; bits; bits &= bits - 1) {
+                    int32_t off = offsets[w * 64 + __builtin_ctzll(bits)];
+                    if (off < 0) continue;
+                    const uint64_t* mask = &succ_masks[off];
+                    for (int k = 0; k < W; ++k) next[k] |= mask[k];
+                    any = 1;
+                }
+            }
+            if (!any) return false;
+            swap(current, next);
+        }
+
+        for (int w = 0; w < W; ++w) {
+            if (current[w] & finals[w]) return true;
+        }
+        return false;
+    }
+
+    bool recognize(const string& word) const { return recognize(word.data(), word.size()); }
+
+    bool isShiftAnd() const { return shift_and; }
+    int getNumClasses() const { return n_classes; }
+};
+
+bool AFND::recognize(const string& word) const {
+    return simulation.get([this] { return make_shared<const BitNFA>(*this); })->recognize(word);
+}
+
+
+
 
 /*
-function NFA-to-DFA(NFA) -> DFA
+ * get-move: estados alcanzables desde states consumiendo symbol (sin clausura)
 */
+unordered_set<int> getMove(const AFND& nfa, const unordered_set<int>& states, char symbol) {
+    unordered_set<int> moves;
+    for (int state : states) {
+        auto it = nfa.getTransitions().find({state, symbol});
+        if (it != nfa.getTransitions().end()) {
+            moves.insert(it->second.begin(), it->second.end());
+        }
+    }
+    return moves;
+}
+
+/**
+ * NFA-to-DFA: construccion de subconjuntos
+ *      Cada estado del AFD es un conjunto de estados del AFND guardado como
+ *      bitset; los conjuntos se identifican por hash (hash-consing), asi que
+ *      cada uno se expande una sola vez. El alfabeto se toma de las
+ *      transiciones del AFND. Los estados sin transicion para un simbolo
+ *      no generan estado muerto: la transicion simplemente no existe
+ * @param max_states Maximo de estados del AFD; si se supera se lanza runtime_error
+ * @param subsets Si no es nulo, recibe el conjunto de estados del AFND de cada estado del AFD
+ */
+AFD NFAtoDFA(const AFND& nfa, int max_states = 100000, vector<vector<int>>* subsets = nullptr) {
+    struct Bitset_Hash {
+        size_t operator()(const vector<uint64_t>& key) const {
+            size_t h = key.size();
+            for (uint64_t w : key) h ^= hash<uint64_t>()(w) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    const int n = nfa.getNumStates();
+    const int W = (n + 63) / 64;
+    vector<uint64_t> closure = epsilonClosureBitsets(nfa);
+
+    // Alfabeto y transiciones por caracter de cada estado
+    vector<int> symbol_index(256, -1);
+    vector<unsigned char> alphabet;
+    vector<vector<pair<int,int>>> moves(n);       // (indice de simbolo, destino)
+    for (const auto& [key, dests] : nfa.getTransitions()) {
+        if (key.second == '\0') continue;
+        unsigned char ch = (unsigned char)key.second;
+        if (symbol_index[ch] < 0) {
+            symbol_index[ch] = (int)alphabet.size();
+            alphabet.push_back(ch);
+        }
+        for (int to : dests) moves[key.first].push_back({symbol_index[ch], to});
+    }
+    const int K = (int)alphabet.size();
+
+    unordered_map<vector<uint64_t>, int, Bitset_Hash> ids;
+    vector<vector<uint64_t>> sets;
+    unordered_map<pair<int,char>, vector<int>, AFND::Pair_Hash> transitions;
+
+    auto intern = [&](vector<uint64_t>& set) {
+        auto it = ids.find(set);
+        if (it != ids.end()) return it->second;
+        if ((int)sets.size() >= max_states) {
+            throw runtime_error("El AFD excede el limite de " + to_string(max_states) + " estados");
+        }
+        int id = (int)sets.size();
+        ids.emplace(set, id);
+        sets.push_back(set);
+        return id;
+    };
+
+    vector<uint64_t> start(closure.begin() + (size_t)nfa.getStartState() * W,
+                           closure.begin() + (size_t)(nfa.getStartState() + 1) * W);
+    intern(start);
+
+    // Acumuladores: destino (clausurado) por simbolo del estado que se expande
+    vector<uint64_t> next((size_t)K * W);
+    vector<char> used(K);
+    vector<uint64_t> key(W);
+    for (size_t d = 0; d < sets.size(); ++d) {
+        fill(next.begin(), next.end(), 0);
+        fill(used.begin(), used.end(), 0);
+        for (int w = 0; w < W; ++w) {
+            for (uint64_t bits = sets[d][w]; bits; bits &= bits - 1) {
+                int s = w * 64 + __builtin_ctzll(bits);
+                for (const auto& m : moves[s]) {
+                    uint64_t* acc = &next[(size_t)m.first * W];
+                    const uint64_t* cl = &closure[(size_t)m.second * W];
+                    for (int k = 0; k < W; ++k) acc[k] |= cl[k];
+                    used[m.first] = 1;
+                }
+            }
+        }
+        for (int a = 0; a < K; ++a) {
+            if (!used[a]) continue;
+            key.assign(next.begin() + (size_t)a * W, next.begin() + (size_t)(a + 1) * W);
+            int to = intern(key);
+            transitions[{(int)d, (char)alphabet[a]}] = {to};
+        }
+    }
+
+    unordered_set<int> finals;
+    for (size_t d = 0; d < sets.size(); ++d) {
+        for (int f : nfa.getFinalStates()) {
+            if ((sets[d][f >> 6] >> (f & 63)) & 1) {
+                finals.insert((int)d);
+                break;
+            }
+        }
+    }
+
+    if (subsets) {
+        subsets->assign(sets.size(), {});
+        for (size_t d = 0; d < sets.size(); ++d) {
+            for (int w = 0; w < W; ++w) {
+                for (uint64_t bits = sets[d][w]; bits; bits &= bits - 1) {
+                    (*subsets)[d].push_back(w * 64 + __builtin_ctzll(bits));
+                }
+            }
+        }
+    }
+
+    return AFD((int)sets.size(), finals, transitions, 0);
+}
+
+/**
+ * NFABuilder
+ *      Construccion de Thompson sobre un unico arreglo de transiciones: los
+ *      fragmentos son solo pares (inicio, aceptacion) dentro del mismo arena,
+ *      asi que combinar fragmentos no copia ningun mapa. El AFND se arma una
+ *      sola vez al final con build()
+ */
+class NFABuilder {
+public:
+    struct Fragment {
+        int start;
+        int accept;
+    };
+
+private:
+    int n_states;
+    vector<pair<int,int>> edge_states;      // (desde, hacia)
+    vector<char> edge_symbols;              // '\0' = epsilon
+
+public:
+    NFABuilder() : n_states(0) {}
+
+    int newState() { return n_states++; }
+    int getNumStates() const { return n_states; }
+
+    void addEdge(int from, char symbol, int to) {
+        edge_states.push_back({from, to});
+        edge_symbols.push_back(symbol);
+    }
+
+    Fragment epsilon() {
+        Fragment f{newState(), newState()};
+        addEdge(f.start, '\0', f.accept);
+        return f;
+    }
+
+    Fragment symbol(char c) {
+        Fragment f{newState(), newState()};
+        addEdge(f.start, c, f.accept);
+        return f;
+    }
+
+    /**
+     * Un fragmento con una transicion por cada byte del conjunto (el byte 0
+     * se reserva para epsilon y se ignora)
+     */
+    Fragment charSet(const bitset<256>& set) {
+        Fragment f{newState(), newState()};
+        for (int b = 1; b < 256; ++b) {
+            if (set[b]) addEdge(f.start, (char)b, f.accept);
+        }
+        return f;
+    }
+
+    // UNION: a | b
+    Fragment unite(Fragment a, Fragment b) {
+        Fragment f{newState(), newState()};
+        addEdge(f.start, '\0', a.start);
+        addEdge(f.start, '\0', b.start);
+        addEdge(a.accept, '\0', f.accept);
+        addEdge(b.accept, '\0', f.accept);
+        return f;
+    }
+
+    // CONCATENATION: a b
+    Fragment concat(Fragment a, Fragment b) {
+        addEdge(a.accept, '\0', b.start);
+        return {a.start, b.accept};
+    }
+
+    // CLOSURE: a*
+    Fragment closure(Fragment a) {
+        Fragment f{newState(), newState()};
+        addEdge(f.start, '\0', a.start);
+        addEdge(f.start, '\0', f.accept);
+        addEdge(a.accept, '\0', a.start);
+        addEdge(a.accept, '\0', f.accept);
+        return f;
+    }
+
+    // a+
+    Fragment plus(Fragment a) {
+        Fragment f{newState(), newState()};
+        addEdge(f.start, '\0', a.start);
+        addEdge(a.accept, '\0', a.start);
+        addEdge(a.accept, '\0', f.accept);
+        return f;
+    }
+
+    // a?
+    Fragment optional(Fragment a) {
+        Fragment f{newState(), newState()};
+        addEdge(f.start, '\0', a.start);
+        addEdge(f.start, '\0', f.accept);
+        addEdge(a.accept, '\0', f.accept);
+        return f;
+    }
+
+    /**
+     * Copia un AFND existente en el arena; sus estados finales pasan por
+     * epsilon al estado de aceptacion del fragmento
+     */
+    Fragment embed(const AFND& nfa) {
+        int offset = n_states;
+        n_states += nfa.getNumStates();
+        for (const auto& [key, dests] : nfa.getTransitions()) {
+            for (int to : dests) addEdge(offset + key.first, key.second, offset + to);
+        }
+        Fragment f{offset + nfa.getStartState(), newState()};
+        for (int s : nfa.getFinalStates()) addEdge(offset + s, '\0', f.accept);
+        return f;
+    }
+
+    /**
+     * Arma el AFND con inicio en start y los estados finales dados
+     */
+    AFND build(int start, const unordered_set<int>& finals) const {
+        unordered_map<pair<int,char>, vector<int>, AFND::Pair_Hash> transitions;
+        transitions.reserve(edge_states.size());
+        for (size_t i = 0; i < edge_states.size(); ++i) {
+            transitions[{edge_states[i].first, edge_symbols[i]}].push_back(edge_states[i].second);
+        }
+        return AFND(n_states, finals, std::move(transitions), start);
+    }
+
+    AFND build(Fragment f) const {
+        return build(f.start, {f.accept});
+    }
+};
 
 /*
 function UNION
 */
+AFND automataUnion(const AFND& a, const AFND& b) {
+    NFABuilder builder;
+    NFABuilder::Fragment fa = builder.embed(a);
+    NFABuilder::Fragment fb = builder.embed(b);
+    return builder.build(builder.unite(fa, fb));
+}
 
 /*
 function CONCATENATION
 */
+AFND automataConcatenation(const AFND& a, const AFND& b) {
+    NFABuilder builder;
+    NFABuilder::Fragment fa = builder.embed(a);
+    NFABuilder::Fragment fb = builder.embed(b);
+    return builder.build(builder.concat(fa, fb));
+}
 
 /*
 function CLOSURE
 */
+AFND automataClosure(const AFND& a) {
+    NFABuilder builder;
+    return builder.build(builder.closure(builder.embed(a)));
+}
+
+/**
+ * MINIMIZATION: algoritmo de Hopcroft, O(n·k·log n)
+ *      Se descartan los estados inalcanzables, se completa el AFD con un estado
+ *      muerto implicito y se refina la particion inicial hasta que sea estable.
+ *      El bloque del estado muerto se elimina del resultado. Los estados se
+ *      renumeran con el inicial como 0
+ * @param bfs_order Si es true se renumera en orden BFS desde el estado inicial
+ *        (simbolos en orden ascendente), para que los estados cercanos queden juntos
+ * @param labels Particion inicial: etiqueta de cada estado, 0 = no final. Por
+ *        defecto 1 para los estados finales y 0 para el resto
+ * @param state_map Si no es nulo, recibe el nuevo estado de cada estado original
+ *        (-1 si se elimino)
+ */
+AFD minimizeDFA(const AFD& dfa, bool bfs_order = false,
+                const vector<int>* labels = nullptr, vector<int>* state_map = nullptr) {
+    const int n_original = dfa.getNumStates();
+
+    // Alfabeto
+    vector<int> symbol_index(256, -1);
+    vector<unsigned char> alphabet;
+    for (const auto& [key, dests] : dfa.getTransitions()) {
+        unsigned char ch = (unsigned char)key.second;
+        if (symbol_index[ch] < 0) {
+            symbol_index[ch] = 0;
+            alphabet.push_back(ch);
+        }
+    }
+    sort(alphabet.begin(), alphabet.end());
+    for (size_t a = 0; a < alphabet.size(); ++a) symbol_index[alphabet[a]] = (int)a;
+    const int K = (int)alphabet.size();
+
+    // Solo estados alcanzables, renumerados 0..n-1; el estado n es el muerto
+    vector<int> reach_id(n_original, -1);
+    vector<int> reached;
+    reach_id[dfa.getStartState()] = 0;
+    reached.push_back(dfa.getStartState());
+    vector<vector<pair<int,int>>> out(n_original);
+    for (const auto& [key, dests] : dfa.getTransitions()) {
+        out[key.first].push_back({symbol_index[(unsigned char)key.second], dests[0]});
+    }
+    for (size_t i = 0; i < reached.size(); ++i) {
+        for (const auto& m : out[reached[i]]) {
+            if (reach_id[m.second] < 0) {
+                reach_id[m.second] = (int)reached.size();
+                reached.push_back(m.second);
+            }
+        }
+    }
+    const int n = (int)reached.size();
+    const int dead = n;
+    const int N = n + 1;
+
+    vector<int> delta((size_t)N * K, dead);
+    for (int s = 0; s < n; ++s) {
+        for (const auto& m : out[reached[s]]) delta[(size_t)s * K + m.first] = reach_id[m.second];
+    }
+
+    // Transiciones inversas en CSR: inv_offset[a * N + t] .. inv_offset[a * N + t + 1]
+    vector<int> inv_offset((size_t)K * N + 1, 0);
+    for (int s = 0; s < N; ++s)
+        for (int a = 0; a < K; ++a) inv_offset[(size_t)a * N + delta[(size_t)s * K + a] + 1]++;
+    for (size_t i = 0; i + 1 < inv_offset.size(); ++i) inv_offset[i + 1] += inv_offset[i];
+    vector<int> inv_source((size_t)N * K);
+    {
+        vector<int> fill_at(inv_offset.begin(), inv_offset.end() - 1);
+        for (int s = 0; s < N; ++s)
+            for (int a = 0; a < K; ++a) inv_source[fill_at[(size_t)a * N + delta[(size_t)s * K + a]]++] = s;
+    }
+
+    // Particion inicial por etiqueta
+    vector<int> label(N, 0);
+    for (int s = 0; s < n; ++s) {
+        int original = reached[s];
+        label[s] = labels ? (*labels)[original] : (dfa.isFinalState(original) ? 1 : 0);
+    }
+
+    vector<int> elems(N), loc(N), block_of(N);
+    vector<int> first, last, mid;
+    {
+        map<int, vector<int>> by_label;
+        for (int s = 0; s < N; ++s) by_label[label[s]].push_back(s);
+        int pos = 0;
+        for (auto& [l, members] : by_label) {
+            int b = (int)first.size();
+            first.push_back(pos);
+            for (int s : members) {
+                elems[pos] = s;
+                loc[s] = pos++;
+                block_of[s] = b;
+            }
+            last.push_back(pos);
+        }
+        mid = first;
+    }
+
+    // Lista de trabajo de pares (bloque, simbolo): todos los bloques menos el mas grande
+    vector<pair<int,int>> worklist;
+    vector<vector<char>> in_worklist;
+    {
+        int largest = 0;
+        for (size_t b = 0; b < first.size(); ++b) {
+            if (last[b] - first[b] > last[largest] - first[largest]) largest = (int)b;
+        }
+        for (size_t b = 0; b < first.size(); ++b) {
+            in_worklist.push_back(vector<char>(K, 0));
+            if ((int)b == largest) continue;
+            for (int a = 0; a < K; ++a) {
+                worklist.push_back({(int)b, a});
+                in_worklist[b][a] = 1;
+            }
+        }
+    }
+
+    vector<int> splitter, predecessors, touched;
+    while (!worklist.empty()) {
+        auto [B, a] = worklist.back();
+        worklist.pop_back();
+        in_worklist[B][a] = 0;
+
+        // Predecesores por a de los estados de B
+        splitter.assign(elems.begin() + first[B], elems.begin() + last[B]);
+        predecessors.clear();
+        for (int t : splitter) {
+            for (int i = inv_offset[(size_t)a * N + t]; i < inv_offset[(size_t)a * N + t + 1]; ++i) {
+                predecessors.push_back(inv_source[i]);
+            }
+        }
+
+        // Marcar: mover cada predecesor al frente de su bloque
+        touched.clear();
+        for (int s : predecessors) {
+            int b = block_of[s];
+            if (loc[s] < mid[b]) continue;
+            if (mid[b] == first[b]) touched.push_back(b);
+            int other = elems[mid[b]];
+            swap(elems[loc[s]], elems[mid[b]]);
+            loc[other] = loc[s];
+            loc[s] = mid[b]++;
+        }
+
+        // Dividir los bloques marcados parcialmente
+        for (int b : touched) {
+            if (mid[b] == last[b]) {
+                mid[b] = first[b];
+                continue;
+            }
+            int nb = (int)first.size();
+            first.push_back(first[b]);
+            last.push_back(mid[b]);
+            mid.push_back(first[b]);
+            first[b] = mid[b];
+            for (int i = first[nb]; i < last[nb]; ++i) block_of[elems[i]] = nb;
+            in_worklist.push_back(vector<char>(K, 0));
+
+            int smaller = (last[nb] - first[nb] <= last[b] - first[b]) ? nb : b;
+            for (int c = 0; c < K; ++c) {
+                int add = in_worklist[b][c] ? nb : smaller;
+                if (!in_worklist[add][c]) {
+                    in_worklist[add][c] = 1;
+                    worklist.push_back({add, c});
+                }
+            }
+        }
+    }
+
+    // Renumerar bloques (sin el del estado muerto), el inicial primero
+    const int dead_block = block_of[dead];
+    vector<int> new_id(first.size(), -1);
+    vector<int> order;
+    auto visit = [&](int b) {
+        if (b != dead_block && new_id[b] < 0) {
+            new_id[b] = (int)order.size();
+            order.push_back(b);
+        }
+    };
+    visit(block_of[0]);
+    if (bfs_order) {
+        for (size_t i = 0; i < order.size(); ++i) {
+            int representative = elems[first[order[i]]];
+            for (int a = 0; a < K; ++a) visit(block_of[delta[(size_t)representative * K + a]]);
+        }
+    } else {
+        for (int s = 0; s < n; ++s) visit(block_of[s]);
+    }
+
+    unordered_set<int> finals;
+    unordered_map<pair<int,char>, vector<int>, AFND::Pair_Hash> transitions;
+    for (size_t i = 0; i < order.size(); ++i) {
+        int representative = elems[first[order[i]]];
+        if (label[representative] != 0) finals.insert((int)i);
+        for (int a = 0; a < K; ++a) {
+            int target = new_id[block_of[delta[(size_t)representative * K + a]]];
+            if (target >= 0) transitions[{(int)i, (char)alphabet[a]}] = {target};
+        }
+    }
+
+    if (state_map) {
+        state_map->assign(n_original, -1);
+        for (int s = 0; s < n; ++s) (*state_map)[reached[s]] = new_id[block_of[s]];
+    }
+
+    // Siempre existe al menos el estado inicial (aunque no acepte nada)
+    return AFD(max((int)order.size(), 1), finals, transitions, 0);
+}
 
-/*
-function MINIMIZATION
-*/
 
@@ -0,0 +1,153 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <filesystem>
+#include <chrono>
+
+//#include "ast.cpp"
+//#include "thread_pool.cpp"
+//#include "source_manager.cpp"
+
+using namespace std;
+
+
+/**
+ * Resultado de compilar un archivo
+ */
+struct CompileResult {
+    string path;
+    size_t bytes = 0;
+    int32_t ast_nodes = 0;
+    vector<string> diagnostics;
+
+    bool ok() const { return diagnostics.empty(); }
+};
+
+
+/**
+ * BatchCompiler
+ *      Compila muchos archivos HULK en paralelo: cada archivo es una tarea
+ *      del ThreadPool que lee el fuente, lo analiza (lexer -> parser -> AST)
+ *      y lo chequea. El lexer, la gramatica y el parser son uno solo, de
+ *      solo lectura, compartido por todos los hilos (parse es const y su
+ *      pila es local a cada llamada); el AST va en la arena del hilo, que se
+ *      reutiliza de un archivo al siguiente. Los fuentes los carga un
+ *      SourceManager, y cada tarea pide la lectura anticipada del archivo
+ *      que sigue al suyo.
+ *      Los resultados quedan en el orden de los archivos de entrada, asi los
+ *      diagnosticos no dependen de la planificacion
+ */
+class BatchCompiler {
+private:
+    const HulkSyntax& syntax;
+    const Lexer& lexer;
+    const LL1Parser& parser;
+
+    // Memoria de cada hilo del pool
+    struct WorkerArena {
+        Ast ast;
+    };
+
+    void compileFile(SourceManager& sources, FileId id, WorkerArena& arena, CompileResult& result) const {
+        const SourceFile* file;
+        try {
+            file = &sources.load(id);
+        } catch (const exception&) {
+            result.diagnostics.push_back("no se pudo abrir el archivo");
+            return;
+        }
+        result.bytes = file->getText().size();
+
+        try {
+            buildHulkAst(parser, syntax, lexer, file->getText(), arena.ast);
+            result.ast_nodes = arena.ast.size();
+            result.diagnostics = checkHulkAst(arena.ast);
+        } catch (const exception& e) {
+            result.diagnostics.push_back(e.what());
+        }
+        sources.release(id);
+    }
+
+public:
+    BatchCompiler(const HulkSyntax& syntax, const Lexer& lexer, const LL1Parser& parser)
+        : syntax(syntax), lexer(lexer), parser(parser) {}
+
+    /**
+     * Compila los archivos con n_threads hilos (0 = uno por nucleo)
+     * @return Un resultado por archivo, en el mismo orden que paths
+     */
+    vector<CompileResult> compile(const vector<string>& paths, int n_threads = 0) const {
+        vector<CompileResult> results(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) results[i].path = paths[i];
+
+        SourceManager sources;
+        vector<FileId> ids(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) ids[i] = sources.getId(paths[i]);
+
+        ThreadPool pool(n_threads);
+        vector<WorkerArena> arenas(pool.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            pool.submit([this, &sources, &ids, &paths, &arenas, &results, i](int worker) {
+                if (i + 1 < paths.size()) sources.prefetch(paths[i + 1]);
+                compileFile(sources, ids[i], arenas[worker], results[i]);
+            });
+        }
+        pool.wait();
+        return results;
+    }
+
+    /**
+     * Archivos .hulk de un directorio (y sus subdirectorios), ordenados
+     */
+    static vector<string> findSources(const string& directory) {
+        vector<string> paths;
+        for (const auto& entry : filesystem::recursive_directory_iterator(directory)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".hulk") {
+                paths.push_back(entry.path().string());
+            }
+        }
+        sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    /**
+     * Imprime los diagnosticos en el orden de los archivos
+     * @return Cantidad de archivos con errores
+     */
+    static size_t printDiagnostics(const vector<CompileResult>& results, ostream& out = cerr) {
+        size_t failed = 0;
+        for (const CompileResult& result : results) {
+            failed += !result.ok();
+            for (const string& diagnostic : result.diagnostics) {
+                out << result.path << ": " << diagnostic << "\n";
+            }
+        }
+        return failed;
+    }
+};
+
+
+
+
+
+
+
+
+// TEST
+// Compilacion en paralelo de ./test/
+void test_BatchCompiler() {
+    HulkSyntax syntax = hulkSyntax();
+    Lexer lexer(hulkLexerRules());
+    LL1Parser parser(syntax.grammar);
+    BatchCompiler compiler(syntax, lexer, parser);
+
+    vector<string> paths = BatchCompiler::findSources("./test/");
+    auto start = chrono::steady_clock::now();
+    vector<CompileResult> results = compiler.compile(paths);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "\n=== COMPILACION EN PARALELO ===\n";
+    size_t failed = BatchCompiler::printDiagnostics(results, cout);
+    cout << results.size() << " archivos, " << failed << " con errores, " << seconds << " s\n";
+}
@@ -0,0 +1,366 @@
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+#include <cstdint>
+
+//#include "parsers.cpp"
+
+using namespace std;
+
+
+/*
+ * Generacion de codigo
+ *      Para una gramatica fija el front end no necesita interpretar tablas:
+ *      generateFrontEnd escribe una unidad de traduccion C++ independiente
+ *      (solo usa la biblioteca estandar) con
+ *
+ *      - nextToken: el AFD del lexer codificado directamente, un bloque con
+ *        etiqueta y un switch sobre el byte por estado (al estilo re2c)
+ *      - parse: el parser LL(1) con un switch por no terminal y, dentro, uno
+ *        por terminal de lookahead que lleva a la produccion; las partes
+ *        derechas se apilan como constantes
+ *
+ *      Los tipos de token del codigo generado son indices densos de la
+ *      gramatica (no ids de la SymbolTable); un token cuya regla no es un
+ *      terminal de la gramatica tiene tipo negativo (-1 - indice en
+ *      UNKNOWN_NAMES). Los eventos y los mensajes de error son los mismos que
+ *      los de LL1Parser sobre un LexerCursor
+ */
+
+
+/**
+ * Literal de C++ para un texto cualquiera
+ */
+string cppStringLiteral(const string& text) {
+    string literal = "\"";
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            literal += '\\';
+            literal += (char)c;
+        } else if (c < 0x20 || c >= 0x7f) {
+            static const char* hex = "0123456789abcdef";
+            literal += "\\x";
+            literal += hex[c >> 4];
+            literal += hex[c & 15];
+            // Corta el literal para que el escape no absorba un digito hexadecimal siguiente
+            if (i + 1 < text.size() && isxdigit((unsigned char)text[i + 1])) literal += "\"\"";
+        } else {
+            literal += (char)c;
+        }
+    }
+    return literal + "\"";
+}
+
+/**
+ * Etiqueta case de un byte: el caracter si es imprimible, si no el numero
+ */
+string cppCaseLabel(int byte) {
+    if (byte >= 0x20 && byte < 0x7f && byte != '\'' && byte != '\\') {
+        return string("case '") + (char)byte + "':";
+    }
+    return "case " + to_string(byte) + ":";
+}
+
+/**
+ * Escribe una lista de etiquetas case, varias por linea
+ */
+void writeCaseLabels(ostream& out, const vector<int>& values, const string& indent,
+                     string (*label)(int)) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        out << (i % 8 == 0 ? indent : " ") << label(values[i]);
+        if (i % 8 == 7 || i + 1 == values.size()) out << "\n";
+    }
+}
+
+string cppIntCaseLabel(int value) { return "case " + to_string(value) + ":"; }
+
+
+/**
+ * Terminales del lexer que no estan en la gramatica, en orden de aparicion
+ */
+vector<Symbol> unknownTokenKinds(const Lexer& lexer, const Grammar& G) {
+    vector<Symbol> kinds;
+    for (const Lexer::Rule& rule : lexer.getRules()) {
+        if (rule.skip || G.indexOf(rule.kind) >= 0) continue;
+        if (find(kinds.begin(), kinds.end(), rule.kind) == kinds.end()) kinds.push_back(rule.kind);
+    }
+    return kinds;
+}
+
+int unknownTokenIndex(const Lexer& lexer, const Grammar& G, const Symbol& kind) {
+    vector<Symbol> kinds = unknownTokenKinds(lexer, G);
+    return (int)(find(kinds.begin(), kinds.end(), kind) - kinds.begin());
+}
+
+
+/**
+ * Escribe nextToken: el AFD de lexer, con las acciones de cada estado de
+ * aceptacion ya traducidas al terminal de G (o a ignorar)
+ */
+void generateLexer(const Lexer& lexer, const Grammar& G, ostream& out) {
+    const DFATable& dfa = lexer.getTable();
+    const vector<Lexer::Rule>& rules = lexer.getRules();
+    const int n_classes = dfa.getNumClasses();
+
+    out << "// Accion de un estado de aceptacion: terminal, token desconocido o ignorar\n"
+        << "constexpr int32_t NO_MATCH = INT32_MIN;\n"
+        << "constexpr int32_t SKIP = INT32_MIN + 1;\n\n";
+
+    out << "[[noreturn]] inline void lexicalError(const char* data, size_t pos, uint32_t line) {\n"
+        << "    size_t column = pos + 1;\n"
+        << "    for (size_t i = pos; i > 0; --i) {\n"
+        << "        if (data[i - 1] == '\\n') {\n"
+        << "            column = pos - i + 1;\n"
+        << "            break;\n"
+        << "        }\n"
+        << "    }\n"
+        << "    throw std::runtime_error(\"Error lexico en linea \" + std::to_string(line) + \", columna \" +\n"
+        << "                             std::to_string(column) + \": caracter inesperado '\" +\n"
+        << "                             std::string(1, data[pos]) + \"'\");\n"
+        << "}\n\n";
+
+    out << "/**\n"
+        << " * Siguiente token no ignorado desde pos (maximal munch), avanzando pos y\n"
+        << " * line. Al terminar el fuente devuelve EOF_TERMINAL\n"
+        << " */\n"
+        << "inline Token nextToken(const char* data, size_t size, size_t& pos, uint32_t& line) {\n"
+        << "    while (pos < size) {\n"
+        << "        size_t i = pos;\n"
+        << "        size_t last = pos;\n"
+        << "        int32_t action = NO_MATCH;\n"
+        << "        goto s" << dfa.startRow() / n_classes << ";\n\n";
+
+    for (int state = 1; state < dfa.getNumStates(); ++state) {
+        int32_t row = state * n_classes;
+        out << "    s" << state << ":\n";
+        if (dfa.isAccepting(row)) {
+            const Lexer::Rule& rule = rules[dfa.label(row) - 1];
+            string action = rule.skip ? "SKIP" : to_string(G.indexOf(rule.kind));
+            if (!rule.skip && G.indexOf(rule.kind) < 0) {
+                action = to_string(-1 - unknownTokenIndex(lexer, G, rule.kind));
+            }
+            out << "        last = i;\n"
+                << "        action = " << action << ";";
+            out << (rule.skip ? "\n" : "    // " + rule.kind.getName() + "\n");
+        }
+
+        map<int32_t, vector<int>> bytes_of_target;
+        for (int b = 1; b < 256; ++b) {
+            int32_t target = dfa.step(row, (unsigned char)b);
+            if (target != DFATable::DEAD) bytes_of_target[target].push_back(b);
+        }
+        if (bytes_of_target.empty()) {
+            out << "        goto done;\n\n";
+            continue;
+        }
+        out << "        if (i >= size) goto done;\n"
+            << "        switch ((unsigned char)data[i++]) {\n";
+        for (const auto& [target, bytes] : bytes_of_target) {
+            writeCaseLabels(out, bytes, "            ", cppCaseLabel);
+            out << "                goto s" << target / n_classes << ";\n";
+        }
+        out << "            default:\n"
+            << "                goto done;\n"
+            << "        }\n\n";
+    }
+
+    out << "    done:\n"
+        << "        if (action == NO_MATCH) lexicalError(data, pos, line);\n"
+        << "        Token token = {action, (uint32_t)pos, (uint32_t)(last - pos), line};\n"
+        << "        for (size_t c = pos; c < last; ++c) line += data[c] == '\\n';\n"
+        << "        pos = last;\n"
+        << "        if (action != SKIP) return token;\n"
+        << "    }\n"
+        << "    return {EOF_TERMINAL, (uint32_t)pos, 0, line};\n"
+        << "}\n\n";
+}
+
+
+/**
+ * Escribe parse: el parser LL(1) de la tabla, leyendo los tokens de nextToken
+ */
+void generateLL1Parser(const ParsingTable& table, ostream& out) {
+    if (!table.isLL1()) {
+        throw runtime_error("La gramatica no es LL(1):\n" + table.conflictReport());
+    }
+    const Grammar& G = table.getGrammar();
+    const LL1Table& TABLE = table.getTable();
+    const int n_terminals = G.numTerminals();
+
+    out << "inline std::string describe(const char* data, const Token& token) {\n"
+        << "    std::string name = token.kind >= 0 ? SYMBOL_NAMES[token.kind] : UNKNOWN_NAMES[-1 - token.kind];\n"
+        << "    return name + \" '\" + std::string(data + token.offset, token.length) + \"' (linea \" +\n"
+        << "           std::to_string(token.line) + \")\";\n"
+        << "}\n\n";
+
+    out << "/**\n"
+        << " * Analiza el fuente completo. listener recibe onProduction(int),\n"
+        << " * onShift(int, const Token&) y onAccept(), en el mismo orden que LL1Parser\n"
+        << " */\n"
+        << "template<typename Listener>\n"
+        << "void parse(const char* data, size_t size, Listener& listener) {\n"
+        << "    size_t pos = 0;\n"
+        << "    uint32_t line = 1;\n"
+        << "    Token token = nextToken(data, size, pos, line);\n"
+        << "    std::vector<int32_t> stack;\n"
+        << "    stack.reserve(64);\n"
+        << "    stack.push_back(EOF_TERMINAL);\n"
+        << "    stack.push_back(" << G.startIndex() << ");\n\n"
+        << "    while (!stack.empty()) {\n"
+        << "        int32_t top = stack.back();\n"
+        << "        stack.pop_back();\n\n"
+        << "        if (top < NUM_TERMINALS) {\n"
+        << "            if (top != token.kind) {\n"
+        << "                throw std::runtime_error(std::string(\"Error sintactico: esperado '\") + SYMBOL_NAMES[top] +\n"
+        << "                                         \"', encontrado \" + describe(data, token));\n"
+        << "            }\n"
+        << "            if (top == EOF_TERMINAL) {\n"
+        << "                listener.onAccept();\n"
+        << "                return;\n"
+        << "            }\n"
+        << "            listener.onShift(top, token);\n"
+        << "            token = nextToken(data, size, pos, line);\n"
+        << "            continue;\n"
+        << "        }\n"
+        << "        if (token.kind < 0) {\n"
+        << "            throw std::runtime_error(\"Simbolo de entrada desconocido: \" + describe(data, token));\n"
+        << "        }\n\n"
+        << "        switch (top) {\n";
+
+    for (int A = n_terminals; A < G.numSymbols(); ++A) {
+        map<int, vector<int>> terminals_of;
+        for (int a = 0; a < n_terminals; ++a) {
+            int p = TABLE.get(A, a);
+            if (p != LL1Table::ERROR) terminals_of[p].push_back(a);
+        }
+
+        out << "        case " << A << ":    // " << G.symbolAt(A).getName() << "\n"
+            << "            switch (token.kind) {\n";
+        for (const auto& [p, terminals] : terminals_of) {
+            writeCaseLabels(out, terminals, "            ", cppIntCaseLabel);
+            out << "                // " << G.getProductions()[p].toString() << "\n"
+                << "                listener.onProduction(" << p << ");\n";
+
+            // Si la parte derecha empieza con el unico terminal que la predice
+            // se desplaza aqui mismo, sin pasar por la pila
+            const int* begin = G.rightBegin(p);
+            if (begin != G.rightEnd(p) && terminals.size() == 1 && *begin == terminals[0]) {
+                out << "                listener.onShift(" << *begin << ", token);\n"
+                    << "                token = nextToken(data, size, pos, line);\n";
+                ++begin;
+            }
+            for (const int* it = G.rightEnd(p); it != begin; ) {
+                out << "                stack.push_back(" << *--it << ");\n";
+            }
+            out << "                continue;\n";
+        }
+        out << "            default:\n"
+            << "                break;\n"
+            << "            }\n"
+            << "            break;\n";
+    }
+
+    out << "        }\n"
+        << "        throw std::runtime_error(std::string(\"Error sintactico: no hay entrada en TABLE[\") +\n"
+        << "                                 SYMBOL_NAMES[top] + \", \" + SYMBOL_NAMES[token.kind] +\n"
+        << "                                 \"], encontrado \" + describe(data, token));\n"
+        << "    }\n"
+        << "}\n\n";
+}
+
+
+/**
+ * Escribe la unidad de traduccion completa: constantes de la gramatica,
+ * nextToken y parse, dentro de name_space
+ */
+void generateFrontEnd(const ParsingTable& table, const Lexer& lexer, const string& name_space, ostream& out) {
+    const Grammar& G = table.getGrammar();
+
+    out << "// Generado por codegen a partir de la gramatica y las reglas lexicas; no editar\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "#include <stdexcept>\n"
+        << "#include <string>\n"
+        << "#include <vector>\n\n"
+        << "namespace " << name_space << " {\n\n";
+
+    out << "constexpr int NUM_TERMINALS = " << G.numTerminals() << ";\n"
+        << "constexpr int NUM_SYMBOLS = " << G.numSymbols() << ";\n"
+        << "constexpr int NUM_PRODUCTIONS = " << G.numProductions() << ";\n"
+        << "constexpr int32_t EOF_TERMINAL = " << G.eofIndex() << ";\n\n";
+
+    out << "// Nombre de cada simbolo por indice denso (terminales, $, no terminales)\n"
+        << "static const char* const SYMBOL_NAMES[NUM_SYMBOLS] = {\n";
+    for (int i = 0; i < G.numSymbols(); ++i) {
+        out << "    " << cppStringLiteral(G.symbolAt(i).getName()) << ",\n";
+    }
+    out << "};\n\n";
+
+    // Un elemento de mas para que el arreglo nunca quede vacio
+    out << "// Tipos de token del lexer que no son terminales de la gramatica\n"
+        << "static const char* const UNKNOWN_NAMES[] = {\n";
+    for (const Symbol& kind : unknownTokenKinds(lexer, G)) {
+        out << "    " << cppStringLiteral(kind.getName()) << ",\n";
+    }
+    out << "    \"\"\n"
+        << "};\n\n";
+
+    out << "static const char* const PRODUCTIONS[NUM_PRODUCTIONS] = {\n";
+    for (const Production& p : G.getProductions()) {
+        out << "    " << cppStringLiteral(p.toString()) << ",\n";
+    }
+    out << "};\n\n";
+
+    out << "// kind: indice del terminal, o -1 - i si es UNKNOWN_NAMES[i]\n"
+        << "struct Token {\n"
+        << "    int32_t kind;\n"
+        << "    uint32_t offset;\n"
+        << "    uint32_t length;\n"
+        << "    uint32_t line;\n"
+        << "};\n\n";
+
+    generateLexer(lexer, G, out);
+    generateLL1Parser(table, out);
+
+    out << "}  // namespace " << name_space << "\n";
+}
+
+void generateFrontEnd(const ParsingTable& table, const Lexer& lexer, const string& name_space,
+                      const string& path) {
+    ostringstream code;
+    generateFrontEnd(table, lexer, name_space, code);
+    ofstream out(path);
+    if (!out) throw runtime_error("No se pudo crear " + path);
+    out << code.str();
+}
+
+
+
+
+
+
+
+
+// TEST
+// Codegen
+void test_Codegen() {
+    HulkSyntax syntax = hulkSyntax();
+    ParsingTable table(syntax.grammar);
+    Lexer lexer(hulkLexerRules());
+
+    ostringstream code;
+    generateFrontEnd(table, lexer, "hulk", code);
+    string text = code.str();
+    cout << "\n=== CODIGO GENERADO ===\n";
+    cout << count(text.begin(), text.end(), '\n') << " lineas, " << text.size() << " bytes, "
+         << lexer.getTable().getNumStates() - 1 << " estados del lexer, "
+         << syntax.grammar.numNonTerminals() << " no terminales\n";
+    cout << text.substr(text.find("inline Token nextToken"), 600) << "...\n";
+}
@@ -4,6 +4,10 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
@@ -11,28 +15,87 @@ using namespace std;
 const string EPSILON = "ε"; 
 
 
+/**
+ * SymbolTable
+ *      Tabla de simbolos: asigna a cada nombre (y tipo) un id entero denso.
+ *      Los simbolos solo guardan el id; el nombre se consulta aqui para
+ *      imprimir y para los mensajes de error
+ */
+class SymbolTable {
+private:
+    vector<string> names;
+    vector<bool> terminal;
+    vector<bool> epsilon;
+    unordered_map<string, int> ids[2];   // [0] no terminales, [1] terminales
+
+public:
+    static SymbolTable& instance() {
+        static SymbolTable table;
+        return table;
+    }
+
+    int intern(const string& name, bool is_terminal) {
+        auto& by_name = ids[is_terminal ? 1 : 0];
+        auto it = by_name.find(name);
+        if (it != by_name.end()) return it->second;
+
+        int id = (int)names.size();
+        names.push_back(name);
+        terminal.push_back(is_terminal);
+        epsilon.push_back(name == EPSILON || name == "epsilon");
+        by_name.emplace(name, id);
+        return id;
+    }
+
+    const string& getName(int id) const { return names[id]; }
+    bool isTerminal(int id) const { return terminal[id]; }
+    bool isEpsilon(int id) const { return epsilon[id]; }
+    size_t size() const { return names.size(); }
+};
+
+
 /**
  * Representa un símbolo de la gramática (terminal o no terminal)
+ *      Internamente es solo un id de la SymbolTable, asi que copiar,
+ *      comparar y hashear un simbolo no toca ningun string
  */
 class Symbol {
 private:
-    string name;
+    int id;
     bool is_terminal;
 
 public:
-    Symbol() = default;
+    Symbol() : id(-1), is_terminal(false) {}
     Symbol(const string& name, bool is_terminal = false) 
-        : name(name), is_terminal(is_terminal) {}
+        : id(SymbolTable::instance().intern(name, is_terminal)), is_terminal(is_terminal) {}
+    
+    /**
+     * Simbolo a partir de su id en la SymbolTable
+     */
+    static Symbol fromId(int id) {
+        Symbol symbol;
+        symbol.id = id;
+        symbol.is_terminal = SymbolTable::instance().isTerminal(id);
+        return symbol;
+    }
     
-    const string& getName() const { return name; }
+    int getId() const { return id; }
+    const string& getName() const {
+        static const string none;
+        return id < 0 ? none : SymbolTable::instance().getName(id);
+    }
     bool isTerminal() const { return is_terminal; }
     bool isNonTerminal() const { return !is_terminal; }
+    bool isEpsilon() const { return id >= 0 && SymbolTable::instance().isEpsilon(id); }
     
     bool operator==(const Symbol& other) const {
-        return name == other.name && is_terminal == other.is_terminal;
+        return id == other.id;
+    }
+    bool operator!=(const Symbol& other) const {
+        return id != other.id;
     }
     bool operator<(const Symbol& other) const {
-        return name < other.name;
+        return getName() < other.getName();
     }
 };
 
@@ -41,7 +104,7 @@ namespace std {
     template<>
     struct hash<Symbol> {
         size_t operator()(const Symbol& s) const {
-            return hash<string>()(s.getName()) ^ hash<bool>()(s.isTerminal());
+            return hash<int>()(s.getId());
         }
     };
 }
@@ -91,9 +154,9 @@ namespace std {
     template<>
     struct hash<Sentence> {
         size_t operator()(const Sentence& s) const {
-            size_t result = 0;
+            size_t result = s.size();
             for (const auto& sym : s) {
-                result ^= hash<string>()(sym.getName()) ^ (hash<bool>()(sym.isTerminal()) << 1);
+                result ^= hash<int>()(sym.getId()) + 0x9e3779b9 + (result << 6) + (result >> 2);
             }
             return result;
         }
@@ -103,90 +166,181 @@ namespace std {
 /**
  * ContainerSet
  *      Representa el conjunto que puede contener símbolos terminales y epsilon
+ *
+ *      Es un bitset de ancho fijo sobre los indices densos de los terminales de
+ *      la gramatica (ver Grammar::indexOf) mas un bit para epsilon. La union se
+ *      hace palabra a palabra (con SSE2 si esta disponible) y dice en la misma
+ *      pasada si el conjunto cambio
  */
 class ContainerSet {
 private:
-    unordered_set<Symbol> symbols;
+    vector<uint64_t> words;
+    int width;
     bool has_epsilon;
-    
-public:
-    ContainerSet() : has_epsilon(false) {}
-    
-    ContainerSet(const Symbol& symbol) : has_epsilon(false) {
-        if (symbol.getName() == EPSILON || symbol.getName() == "epsilon") {
-            has_epsilon = true;
-        } else {
-            symbols.insert(symbol);
+
+    static size_t wordsFor(int width) { return (width + 63) / 64; }
+
+    void grow(int new_width) {
+        if (new_width > width) {
+            width = new_width;
+            words.resize(wordsFor(width), 0);
         }
     }
     
+public:
+    ContainerSet(int width = 0) : words(wordsFor(width), 0), width(width), has_epsilon(false) {}
+    
     void setEpsilon() {
         has_epsilon = true;
     }
     
+    void clearEpsilon() {
+        has_epsilon = false;
+    }
+    
     bool containsEpsilon() const {
         return has_epsilon;
     }
     
-    void insert(const Symbol& symbol) {
-        if (symbol.getName() == EPSILON || symbol.getName() == "epsilon") {
+    void insert(int terminal) {
+        grow(terminal + 1);
+        words[terminal >> 6] |= uint64_t(1) << (terminal & 63);
+    }
+    
+    bool contains(int terminal) const {
+        return terminal < width && (words[terminal >> 6] >> (terminal & 63)) & 1;
+    }
+    
+    /**
+     * Union con otro conjunto; devuelve true si se añadio algun elemento
+     * @param with_epsilon Si es false se ignora el epsilon de other
+     */
+    bool hardUpdate(const ContainerSet& other, bool with_epsilon = true) {
+        grow(other.width);
+        
+        uint64_t* dst = words.data();
+        const uint64_t* src = other.words.data();
+        size_t n = other.words.size();
+        size_t i = 0;
+        uint64_t added = 0;
+#ifdef __SSE2__
+        __m128i added_v = _mm_setzero_si128();
+        for (; i + 2 <= n; i += 2) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(dst + i));
+            __m128i b = _mm_loadu_si128((const __m128i*)(src + i));
+            added_v = _mm_or_si128(added_v, _mm_andnot_si128(a, b));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(a, b));
+        }
+        added = _mm_movemask_epi8(_mm_cmpeq_epi8(added_v, _mm_setzero_si128())) != 0xFFFF;
+#endif
+        for (; i < n; ++i) {
+            added |= src[i] & ~dst[i];
+            dst[i] |= src[i];
+        }
+        
+        if (with_epsilon && other.has_epsilon && !has_epsilon) {
             has_epsilon = true;
-        } else {
-            symbols.insert(symbol);
+            return true;
         }
+        return added != 0;
     }
     
     void update(const ContainerSet& other) {
-        for (const auto& symbol : other.symbols) {
-            symbols.insert(symbol);
+        hardUpdate(other);
+    }
+    
+    /**
+     * Diferencia como mascara: elementos de este conjunto que no estan en other
+     */
+    ContainerSet operator-(const ContainerSet& other) const {
+        ContainerSet result = *this;
+        size_t n = min(result.words.size(), other.words.size());
+        for (size_t i = 0; i < n; ++i) {
+            result.words[i] &= ~other.words[i];
         }
         if (other.has_epsilon) {
-            has_epsilon = true;
+            result.has_epsilon = false;
         }
+        return result;
     }
     
-    bool hardUpdate(const ContainerSet& other) {
-        size_t old_size = symbols.size();
-        bool old_epsilon = has_epsilon;
-        
-        update(other);
-        
-        return symbols.size() != old_size || has_epsilon != old_epsilon;
+    bool operator==(const ContainerSet& other) const {
+        if (has_epsilon != other.has_epsilon) return false;
+        size_t n = max(words.size(), other.words.size());
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t a = i < words.size() ? words[i] : 0;
+            uint64_t b = i < other.words.size() ? other.words[i] : 0;
+            if (a != b) return false;
+        }
+        return true;
     }
     
-    ContainerSet operator-(const unordered_set<string>& to_remove) const {
-        ContainerSet result;
-        
-        for (const auto& symbol : symbols) {
-            if (to_remove.find(symbol.getName()) == to_remove.end()) {
-                result.insert(symbol);
+    /**
+     * Cantidad de terminales del conjunto (sin contar epsilon)
+     */
+    size_t size() const {
+        size_t count = 0;
+        for (uint64_t w : words) count += __builtin_popcountll(w);
+        return count;
+    }
+    
+    bool empty() const {
+        if (has_epsilon) return false;
+        for (uint64_t w : words) {
+            if (w) return false;
+        }
+        return true;
+    }
+    
+    /**
+     * Iterador sobre los indices de los terminales presentes (usa ctz)
+     */
+    class iterator {
+    private:
+        const uint64_t* words;
+        size_t n_words;
+        size_t word_index;
+        uint64_t current;
+
+        void advance() {
+            while (current == 0 && word_index < n_words) {
+                if (++word_index < n_words) current = words[word_index];
             }
         }
-        
-        if (has_epsilon && to_remove.find(EPSILON) == to_remove.end() && 
-            to_remove.find("epsilon") == to_remove.end()) {
-            result.setEpsilon();
+
+    public:
+        iterator(const uint64_t* words, size_t n_words, size_t word_index)
+            : words(words), n_words(n_words), word_index(word_index),
+              current(word_index < n_words ? words[word_index] : 0) {
+            advance();
         }
-        
-        return result;
-    }
+        int operator*() const { return (int)(word_index * 64 + __builtin_ctzll(current)); }
+        iterator& operator++() {
+            current &= current - 1;
+            advance();
+            return *this;
+        }
+        bool operator!=(const iterator& other) const {
+            return word_index != other.word_index || current != other.current;
+        }
+    };
     
-    void print() const {
+    iterator begin() const { return iterator(words.data(), words.size(), 0); }
+    iterator end() const { return iterator(words.data(), words.size(), words.size()); }
+    
+    int getWidth() const { return width; }
+    const vector<uint64_t>& getWords() const { return words; }
+    
+    void print(const vector<Symbol>& terminals) const {
         cout << "{ ";
-        for (const auto& symbol : symbols) {
-            cout << symbol.getName() << " ";
+        for (int t : *this) {
+            cout << terminals[t].getName() << " ";
         }
         if (has_epsilon) {
             cout << EPSILON << " ";
         }
         cout << "}";
     }
-    
-    bool empty() const {
-        return symbols.empty() && !has_epsilon;
-    }
-    
-    const unordered_set<Symbol>& getSymbols() const { return symbols; }
 };
 
 
@@ -222,6 +376,12 @@ public:
 /**
  * Grammar
  *      Representa una gramatica libre de contexto
+ *
+ *      Ademas de los conjuntos de simbolos, la gramatica numera sus simbolos
+ *      con indices densos: primero los terminales (ordenados por nombre), luego
+ *      $ y por ultimo los no terminales. Las producciones se guardan tambien
+ *      aplanadas sobre esos indices para que los algoritmos de analisis
+ *      trabajen sobre vectores de enteros
  */
 class Grammar {
 private:
@@ -229,6 +389,72 @@ private:
     unordered_set<Symbol> nonTerminals;
     Symbol startSymbol;
     vector<Production> productions;
+
+    // Numeracion densa
+    Symbol eofSymbol;
+    vector<Symbol> symbols;        // indice -> simbolo
+    vector<int> index_of;          // id de la SymbolTable -> indice (-1 si no pertenece)
+    int n_terminals;               // incluye $
+
+    // Producciones aplanadas: la parte derecha de p es rhs[rhs_offset[p] .. rhs_offset[p+1])
+    vector<int> prod_left;
+    vector<int> rhs_offset;
+    vector<int> rhs;
+    // Las producciones de A son by_left[by_left_offset[A - n_terminals] .. by_left_offset[A - n_terminals + 1])
+    vector<int> by_left_offset;
+    vector<int> by_left;
+
+    void buildIndex() {
+        vector<Symbol> ts(terminals.begin(), terminals.end());
+        vector<Symbol> nts(nonTerminals.begin(), nonTerminals.end());
+
+        // Simbolos que aparecen en producciones pero no se declararon
+        for (const Production& p : productions) {
+            if (!nonTerminals.count(p.getLeft())) nts.push_back(p.getLeft());
+            for (const Symbol& sym : p.getRight()) {
+                if (sym.isEpsilon()) continue;
+                if (sym.isTerminal() && !terminals.count(sym)) ts.push_back(sym);
+                if (sym.isNonTerminal() && !nonTerminals.count(sym)) nts.push_back(sym);
+            }
+        }
+        auto by_name = [](const Symbol& a, const Symbol& b) { return a.getName() < b.getName(); };
+        sort(ts.begin(), ts.end(), by_name);
+        ts.erase(unique(ts.begin(), ts.end()), ts.end());
+        ts.erase(remove(ts.begin(), ts.end(), eofSymbol), ts.end());
+        ts.erase(remove_if(ts.begin(), ts.end(), [](const Symbol& t) { return t.isEpsilon(); }), ts.end());
+        sort(nts.begin(), nts.end(), by_name);
+        nts.erase(unique(nts.begin(), nts.end()), nts.end());
+
+        symbols = ts;
+        symbols.push_back(eofSymbol);
+        n_terminals = (int)symbols.size();
+        symbols.insert(symbols.end(), nts.begin(), nts.end());
+
+        index_of.assign(SymbolTable::instance().size(), -1);
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            index_of[symbols[i].getId()] = (int)i;
+        }
+
+        prod_left.clear();
+        rhs_offset.assign(1, 0);
+        rhs.clear();
+        for (const Production& p : productions) {
+            prod_left.push_back(indexOf(p.getLeft()));
+            for (const Symbol& sym : p.getRight()) {
+                if (!sym.isEpsilon()) rhs.push_back(indexOf(sym));
+            }
+            rhs_offset.push_back((int)rhs.size());
+        }
+
+        // Producciones agrupadas por no terminal izquierdo (orden de conteo)
+        int n_nonterminals = (int)symbols.size() - n_terminals;
+        by_left_offset.assign(n_nonterminals + 1, 0);
+        for (int left : prod_left) ++by_left_offset[left - n_terminals + 1];
+        for (int A = 0; A < n_nonterminals; ++A) by_left_offset[A + 1] += by_left_offset[A];
+        by_left.assign(prod_left.size(), 0);
+        vector<int> next(by_left_offset.begin(), by_left_offset.end() - 1);
+        for (int p = 0; p < (int)prod_left.size(); ++p) by_left[next[prod_left[p] - n_terminals]++] = p;
+    }
     
 public:
     Grammar(const unordered_set<Symbol>& terminals,
@@ -236,12 +462,45 @@ public:
             const Symbol& startSymbol,
             const vector<Production>& productions)
         : terminals(terminals), nonTerminals(nonTerminals), 
-          startSymbol(startSymbol), productions(productions) {}
+          startSymbol(startSymbol), productions(productions),
+          eofSymbol("$", true) {
+        buildIndex();
+    }
     
     const unordered_set<Symbol>& getTerminals() const { return terminals; }
     const unordered_set<Symbol>& getNonTerminals() const { return nonTerminals; }
     const Symbol& getStartSymbol() const { return startSymbol; }
     const vector<Production>& getProductions() const { return productions; }
+    const Symbol& getEOF() const { return eofSymbol; }
+
+    // Indices densos
+    int indexOf(const Symbol& s) const {
+        return indexOfId(s.getId());
+    }
+    int indexOfId(int id) const {
+        return (id >= 0 && id < (int)index_of.size()) ? index_of[id] : -1;
+    }
+    const Symbol& symbolAt(int index) const { return symbols[index]; }
+    const vector<Symbol>& getSymbols() const { return symbols; }
+    int numSymbols() const { return (int)symbols.size(); }
+    int numTerminals() const { return n_terminals; }
+    int numNonTerminals() const { return (int)symbols.size() - n_terminals; }
+    bool isTerminalIndex(int index) const { return index < n_terminals; }
+    int eofIndex() const { return n_terminals - 1; }
+    int startIndex() const { return indexOf(startSymbol); }
+
+    // Producciones aplanadas
+    int numProductions() const { return (int)prod_left.size(); }
+    int leftIndex(int p) const { return prod_left[p]; }
+    const int* rightBegin(int p) const { return rhs.data() + rhs_offset[p]; }
+    const int* rightEnd(int p) const { return rhs.data() + rhs_offset[p + 1]; }
+    int rightSize(int p) const { return rhs_offset[p + 1] - rhs_offset[p]; }
+    // Posicion global del primer simbolo de la parte derecha de p (en [0, numPositions()))
+    int rightOffset(int p) const { return rhs_offset[p]; }
+    int numPositions() const { return (int)rhs.size(); }
+    // Producciones del no terminal A, en orden
+    const int* productionsBegin(int A) const { return by_left.data() + by_left_offset[A - n_terminals]; }
+    const int* productionsEnd(int A) const { return by_left.data() + by_left_offset[A - n_terminals + 1]; }
     
     void print() const {
         cout << "Gramatica:\n";
@@ -260,4 +519,3 @@ public:
         }
     }
 };
-
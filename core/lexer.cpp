@@ -0,0 +1,553 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <unordered_set>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <bitset>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HULK_LEXER_AVX2 1
+#endif
+
+//#include "grammar.cpp"
+//#include "reg_exp.cpp"
+
+using namespace std;
+
+
+/**
+ * Token suelto, tal como lo entrega el lexer al pedirlo de a uno
+ * (ver TokenStream para la salida completa en arreglos)
+ */
+struct Token {
+    int32_t kind;       // id del terminal en la SymbolTable
+    uint32_t offset;
+    uint32_t length;
+    uint32_t line;
+};
+
+
+/**
+ * TokenStream
+ *      Salida del lexer en forma de estructura de arreglos: tipo, inicio,
+ *      largo y linea de cada token en arreglos contiguos separados. El texto
+ *      de un token es una vista sobre el codigo fuente (no se copia), asi que
+ *      el buffer del fuente debe vivir mientras se use el stream.
+ *      El tipo es el id del terminal en la SymbolTable
+ */
+class TokenStream {
+private:
+    string_view source;
+    vector<int32_t> kinds;
+    vector<uint32_t> offsets;
+    vector<uint32_t> lengths;
+    vector<uint32_t> lines;
+
+public:
+    TokenStream() = default;
+    explicit TokenStream(string_view source) : source(source) {}
+
+    void reserve(size_t n) {
+        kinds.reserve(n);
+        offsets.reserve(n);
+        lengths.reserve(n);
+        lines.reserve(n);
+    }
+
+    void push(int32_t kind, uint32_t offset, uint32_t length, uint32_t line) {
+        kinds.push_back(kind);
+        offsets.push_back(offset);
+        lengths.push_back(length);
+        lines.push_back(line);
+    }
+
+    /**
+     * Vacia el stream conservando la memoria reservada y lo asocia a otro fuente
+     */
+    void reset(string_view new_source) {
+        source = new_source;
+        kinds.clear();
+        offsets.clear();
+        lengths.clear();
+        lines.clear();
+    }
+
+    size_t size() const { return kinds.size(); }
+    bool empty() const { return kinds.empty(); }
+
+    int32_t kind(size_t i) const { return kinds[i]; }
+    uint32_t offset(size_t i) const { return offsets[i]; }
+    uint32_t length(size_t i) const { return lengths[i]; }
+    uint32_t line(size_t i) const { return lines[i]; }
+    string_view text(size_t i) const { return source.substr(offsets[i], lengths[i]); }
+    Symbol symbol(size_t i) const { return Symbol::fromId(kinds[i]); }
+
+    /**
+     * Columna (desde 1) del token; se calcula buscando el salto de linea anterior
+     */
+    uint32_t column(size_t i) const {
+        size_t line_start = source.rfind('\n', offsets[i] == 0 ? 0 : offsets[i] - 1);
+        if (offsets[i] == 0 || line_start == string_view::npos) return offsets[i] + 1;
+        return (uint32_t)(offsets[i] - line_start);
+    }
+
+    string_view getSource() const { return source; }
+    const int32_t* kindData() const { return kinds.data(); }
+    const uint32_t* offsetData() const { return offsets.data(); }
+    const uint32_t* lengthData() const { return lengths.data(); }
+    const uint32_t* lineData() const { return lines.data(); }
+};
+
+
+/**
+ * ByteRun
+ *      Conjunto de bytes sobre el que un estado del AFD del lexer vuelve a si
+ *      mismo (espacios, caracteres de identificador, digitos, cuerpo de un
+ *      string o de un comentario). Mientras la entrada siga dentro del conjunto
+ *      el AFD no cambia de estado, asi que la racha se puede saltar sin tabla.
+ *
+ *      El conjunto se guarda como a lo sumo MAX_RANGES rangos [low, low + width];
+ *      si el complemento se describe con menos rangos se guarda este y se marca
+ *      negated (p. ej. el cuerpo de un string: todo salvo '"', '\\' y '\n').
+ *      skip() compara 32 bytes (AVX2) o 16 (SSE2) por iteracion con la prueba
+ *      de rango sin signo (x - low) <= width; la version se elige una vez en
+ *      tiempo de ejecucion segun el CPU, con una version escalar de respaldo
+ */
+class ByteRun {
+public:
+    static const int MAX_RANGES = 4;
+
+private:
+    int n_ranges = 0;
+    bool negated = false;
+    uint8_t low[MAX_RANGES];
+    uint8_t width[MAX_RANGES];
+    bool member[256];
+
+    typedef size_t (*SkipFunction)(const ByteRun&, const char*, size_t, size_t);
+
+    static vector<pair<int, int>> rangesOf(const bitset<256>& set) {
+        vector<pair<int, int>> ranges;
+        for (int b = 0; b < 256; ++b) {
+            if (!set[b]) continue;
+            int e = b;
+            while (e + 1 < 256 && set[e + 1]) ++e;
+            ranges.push_back({b, e});
+            b = e;
+        }
+        return ranges;
+    }
+
+    static size_t skipScalar(const ByteRun& run, const char* data, size_t pos, size_t size) {
+        while (pos < size && run.member[(unsigned char)data[pos]]) ++pos;
+        return pos;
+    }
+
+#ifdef __SSE2__
+    static size_t skipSSE2(const ByteRun& run, const char* data, size_t pos, size_t size) {
+        __m128i lows[MAX_RANGES], widths[MAX_RANGES];
+        for (int r = 0; r < run.n_ranges; ++r) {
+            lows[r] = _mm_set1_epi8((char)run.low[r]);
+            widths[r] = _mm_set1_epi8((char)run.width[r]);
+        }
+        const unsigned flip = run.negated ? 0 : 0xFFFFu;
+
+        while (pos + 16 <= size) {
+            __m128i x = _mm_loadu_si128((const __m128i*)(data + pos));
+            __m128i in = _mm_setzero_si128();
+            for (int r = 0; r < run.n_ranges; ++r) {
+                __m128i d = _mm_sub_epi8(x, lows[r]);
+                in = _mm_or_si128(in, _mm_cmpeq_epi8(_mm_min_epu8(d, widths[r]), d));
+            }
+            // Bits en 1: bytes que terminan la racha
+            unsigned stop = ((unsigned)_mm_movemask_epi8(in) ^ flip) & 0xFFFFu;
+            if (stop) return pos + __builtin_ctz(stop);
+            pos += 16;
+        }
+        return skipScalar(run, data, pos, size);
+    }
+#endif
+
+#ifdef HULK_LEXER_AVX2
+    __attribute__((target("avx2")))
+    static size_t skipAVX2(const ByteRun& run, const char* data, size_t pos, size_t size) {
+        __m256i lows[MAX_RANGES], widths[MAX_RANGES];
+        for (int r = 0; r < run.n_ranges; ++r) {
+            lows[r] = _mm256_set1_epi8((char)run.low[r]);
+            widths[r] = _mm256_set1_epi8((char)run.width[r]);
+        }
+        const uint32_t flip = run.negated ? 0 : 0xFFFFFFFFu;
+
+        while (pos + 32 <= size) {
+            __m256i x = _mm256_loadu_si256((const __m256i*)(data + pos));
+            __m256i in = _mm256_setzero_si256();
+            for (int r = 0; r < run.n_ranges; ++r) {
+                __m256i d = _mm256_sub_epi8(x, lows[r]);
+                in = _mm256_or_si256(in, _mm256_cmpeq_epi8(_mm256_min_epu8(d, widths[r]), d));
+            }
+            uint32_t stop = (uint32_t)_mm256_movemask_epi8(in) ^ flip;
+            if (stop) return pos + __builtin_ctz(stop);
+            pos += 32;
+        }
+        return skipScalar(run, data, pos, size);
+    }
+#endif
+
+    static SkipFunction chooseSkip() {
+#ifdef HULK_LEXER_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return skipAVX2;
+#endif
+#ifdef __SSE2__
+        return skipSSE2;
+#else
+        return skipScalar;
+#endif
+    }
+
+public:
+    ByteRun() { fill(member, member + 256, false); }
+
+    /**
+     * Intenta representar el conjunto; falla si ni el ni su complemento caben
+     * en MAX_RANGES rangos
+     */
+    static bool build(const bitset<256>& set, ByteRun& run) {
+        vector<pair<int, int>> ranges = rangesOf(set);
+        vector<pair<int, int>> complement = rangesOf(~set);
+        run.negated = complement.size() < ranges.size();
+        if (run.negated) ranges.swap(complement);
+        if (ranges.empty() || (int)ranges.size() > MAX_RANGES) return false;
+
+        run.n_ranges = (int)ranges.size();
+        for (int r = 0; r < run.n_ranges; ++r) {
+            run.low[r] = (uint8_t)ranges[r].first;
+            run.width[r] = (uint8_t)(ranges[r].second - ranges[r].first);
+        }
+        for (int b = 0; b < 256; ++b) run.member[b] = set[b];
+        return true;
+    }
+
+    /**
+     * Primera posicion >= pos cuyo byte no esta en el conjunto (o size)
+     */
+    size_t skip(const char* data, size_t pos, size_t size) const {
+        static const SkipFunction implementation = chooseSkip();
+        return implementation(*this, data, pos, size);
+    }
+
+    size_t skipScalar(const char* data, size_t pos, size_t size) const {
+        return skipScalar(*this, data, pos, size);
+    }
+
+    bool contains(unsigned char byte) const { return member[byte]; }
+    bool isNegated() const { return negated; }
+    int numRanges() const { return n_ranges; }
+};
+
+
+/**
+ * Lexer
+ *      Generador de analizadores lexicos: a partir de reglas (regex, terminal,
+ *      prioridad) construye un unico AFD con todos los patrones y lo recorre
+ *      con maxima coincidencia (maximal munch). Si dos reglas reconocen el mismo
+ *      lexema mas largo gana la de mayor prioridad, y a igual prioridad la que
+ *      se declaro primero.
+ *
+ *      Construccion: cada regla se agrega por Thompson al mismo NFABuilder con
+ *      su propio estado de aceptacion -> NFAtoDFA (cada estado del AFD se
+ *      etiqueta con la mejor regla que contiene) -> minimizeDFA respetando las
+ *      etiquetas -> DFATable. Al analizar se hace una sola pasada del AFD por
+ *      token, no una por patron
+ */
+class Lexer {
+public:
+    struct Rule {
+        string pattern;
+        Symbol kind;
+        int priority;
+        bool skip;      // espacios, comentarios: se reconocen pero no se emiten
+    };
+
+    /**
+     * Regla para una palabra clave: el texto literal con prioridad alta para
+     * que gane frente al identificador del mismo largo
+     */
+    static Rule keyword(const string& word, const Symbol& kind, int priority = 10) {
+        return {escape(word), kind, priority, false};
+    }
+
+    static Rule token(const string& pattern, const Symbol& kind, int priority = 0) {
+        return {pattern, kind, priority, false};
+    }
+
+    static Rule skip(const string& pattern) {
+        return {pattern, Symbol(), 0, true};
+    }
+
+    /**
+     * Escapa un texto para usarlo como patron literal
+     */
+    static string escape(const string& text) {
+        string escaped;
+        for (char c : text) {
+            if (string("\\|*+?()[].").find(c) != string::npos) escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+private:
+    vector<Rule> rules;
+    vector<int32_t> kind_ids;       // id en la SymbolTable del terminal de cada regla
+    shared_ptr<const DFATable> table;
+    Symbol eof;
+    vector<ByteRun> runs;
+    vector<int16_t> run_of_state;   // ByteRun de los lazos de cada estado (-1 = ninguno)
+
+    void build(int max_dfa_states) {
+        for (const Rule& rule : rules) kind_ids.push_back(rule.kind.getId());
+
+        NFABuilder builder;
+        int start = builder.newState();
+        vector<int> rule_of_state;
+        unordered_set<int> finals;
+
+        for (size_t r = 0; r < rules.size(); ++r) {
+            NFABuilder::Fragment f = RegexParser(rules[r].pattern, builder).parse();
+            builder.addEdge(start, '\0', f.start);
+            finals.insert(f.accept);
+            if ((int)rule_of_state.size() < builder.getNumStates()) {
+                rule_of_state.resize(builder.getNumStates(), -1);
+            }
+            rule_of_state[f.accept] = (int)r;
+        }
+        rule_of_state.resize(builder.getNumStates(), -1);
+
+        AFND nfa = builder.build(start, finals);
+        vector<vector<int>> subsets;
+        AFD dfa = NFAtoDFA(nfa, max_dfa_states, &subsets);
+
+        // Etiqueta de cada estado del AFD: 1 + mejor regla aceptada (0 = ninguna)
+        vector<int> labels(dfa.getNumStates(), 0);
+        for (int d = 0; d < dfa.getNumStates(); ++d) {
+            int best = -1;
+            for (int s : subsets[d]) {
+                int r = rule_of_state[s];
+                if (r < 0) continue;
+                if (best < 0 || rules[r].priority > rules[best].priority ||
+                    (rules[r].priority == rules[best].priority && r < best)) {
+                    best = r;
+                }
+            }
+            labels[d] = best + 1;
+        }
+
+        vector<int> state_map;
+        AFD minimal = minimizeDFA(dfa, true, &labels, &state_map);
+        vector<int> minimal_labels(minimal.getNumStates(), 0);
+        for (int d = 0; d < dfa.getNumStates(); ++d) {
+            if (state_map[d] >= 0) minimal_labels[state_map[d]] = labels[d];
+        }
+        table = make_shared<const DFATable>(minimal, &minimal_labels);
+        buildRuns();
+    }
+
+    /**
+     * Detecta los estados con lazos sobre si mismos para saltar sus rachas
+     * sin recorrer la tabla byte a byte. Los lazos sobre muy pocos bytes no
+     * compensan la llamada (p. ej. "**" no forma rachas)
+     */
+    void buildRuns() {
+        const DFATable& dfa = *table;
+        const int n_classes = dfa.getNumClasses();
+        run_of_state.assign(dfa.getNumStates(), -1);
+
+        for (int state = 1; state < dfa.getNumStates(); ++state) {
+            int32_t row = state * n_classes;
+            bitset<256> loop;
+            for (int b = 1; b < 256; ++b) {
+                if (dfa.step(row, (unsigned char)b) == row) loop[b] = true;
+            }
+            ByteRun run;
+            if (loop.count() < 4 || !ByteRun::build(loop, run)) continue;
+            run_of_state[state] = (int16_t)runs.size();
+            runs.push_back(run);
+        }
+    }
+
+    [[noreturn]] void lexicalError(string_view source, size_t pos, uint32_t line) const {
+        size_t line_start = source.rfind('\n', pos == 0 ? 0 : pos - 1);
+        size_t column = (pos == 0 || line_start == string_view::npos) ? pos + 1 : pos - line_start;
+        throw runtime_error("Error lexico en linea " + to_string(line) + ", columna " +
+                            to_string(column) + ": caracter inesperado '" + string(1, source[pos]) + "'");
+    }
+
+public:
+    Lexer(const vector<Rule>& rules, int max_dfa_states = 100000)
+        : rules(rules), eof("$", true) {
+        build(max_dfa_states);
+    }
+
+    /**
+     * Largo del token mas largo que empieza en pos (0 si ninguno)
+     * @param rule Recibe la regla ganadora
+     */
+    size_t longestMatch(const char* data, size_t size, size_t pos, int& rule) const {
+        const DFATable& dfa = *table;
+        int32_t row = dfa.startRow();
+        size_t last_accept = pos;
+        int32_t accept_row = DFATable::DEAD;
+
+        const int n_classes = dfa.getNumClasses();
+
+        for (size_t i = pos; i < size; ) {
+            row = dfa.step(row, (unsigned char)data[i++]);
+            if (row == DFATable::DEAD) break;
+
+            // En un estado con lazo la racha entera se queda en el mismo estado
+            int run = run_of_state[row / n_classes];
+            if (run >= 0 && i < size && runs[run].contains((unsigned char)data[i])) {
+                i = runs[run].skip(data, i + 1, size);
+            }
+            if (dfa.isAccepting(row)) {
+                last_accept = i;
+                accept_row = row;
+            }
+        }
+        rule = accept_row == DFATable::DEAD ? -1 : dfa.label(accept_row) - 1;
+        return last_accept - pos;
+    }
+
+    /**
+     * Reconoce el siguiente token no ignorado desde pos, avanzando pos y line.
+     * Al terminar el fuente devuelve $ (y lo sigue devolviendo)
+     */
+    Token next(string_view source, size_t& pos, uint32_t& line) const {
+        while (pos < source.size()) {
+            int rule;
+            size_t length = longestMatch(source.data(), source.size(), pos, rule);
+            if (length == 0) {
+                lexicalError(source, pos, line);
+            }
+
+            Token token = {kind_ids[rule], (uint32_t)pos, (uint32_t)length, line};
+            const char* end = source.data() + pos + length;
+            for (const char* c = source.data() + pos; (c = (const char*)memchr(c, '\n', end - c)); ++c) {
+                ++line;
+            }
+            pos += length;
+            if (!rules[rule].skip) return token;
+        }
+        return {eof.getId(), (uint32_t)pos, 0, line};
+    }
+
+    /**
+     * Divide el codigo fuente en tokens sin copiar su texto; el ultimo es siempre $
+     * @param tokens Se vacia y se llena (permite reutilizar su memoria)
+     */
+    void scan(string_view source, TokenStream& tokens) const {
+        tokens.reset(source);
+        tokens.reserve(source.size() / 4 + 1);
+        size_t pos = 0;
+        uint32_t line = 1;
+
+        Token token;
+        do {
+            token = next(source, pos, line);
+            tokens.push(token.kind, token.offset, token.length, token.line);
+        } while (token.kind != eof.getId());
+    }
+
+    TokenStream scan(string_view source) const {
+        TokenStream tokens;
+        scan(source, tokens);
+        return tokens;
+    }
+
+    /**
+     * Solo los terminales, listos para LL1Parser::parse(vector<Symbol>)
+     */
+    vector<Symbol> tokenizeSymbols(string_view source) const {
+        TokenStream tokens = scan(source);
+        vector<Symbol> symbols;
+        symbols.reserve(tokens.size());
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            symbols.push_back(tokens.symbol(i));
+        }
+        return symbols;
+    }
+
+    const vector<Rule>& getRules() const { return rules; }
+    const DFATable& getTable() const { return *table; }
+    const Symbol& getEOF() const { return eof; }
+};
+
+
+/**
+ * LexerCursor
+ *      Lectura bajo demanda: el lexer avanza solo cuando se pide el siguiente
+ *      token, con un token de lookahead ya reconocido (peek). Sirve para
+ *      analizar archivos grandes sin guardar todos sus tokens
+ */
+class LexerCursor {
+private:
+    const Lexer& lexer;
+    string_view source;
+    size_t pos;
+    uint32_t line;
+    Token token;
+
+public:
+    LexerCursor(const Lexer& lexer, string_view source)
+        : lexer(lexer), source(source), pos(0), line(1) {
+        token = lexer.next(source, pos, line);
+    }
+
+    const Token& peek() const { return token; }
+    void advance() { token = lexer.next(source, pos, line); }
+    bool atEnd() const { return token.kind == lexer.getEOF().getId(); }
+
+    string_view text(const Token& t) const { return source.substr(t.offset, t.length); }
+    string_view getSource() const { return source; }
+};
+
+
+/**
+ * Reglas lexicas de HULK (ver https://matcom.in/hulk/)
+ *      Los terminales se llaman como el texto del operador o palabra clave;
+ *      ademas: id, number, string
+ */
+vector<Lexer::Rule> hulkLexerRules() {
+    vector<Lexer::Rule> rules;
+
+    for (const char* word : {"let", "in", "function", "if", "elif", "else", "while", "for",
+                             "type", "new", "inherits", "protocol", "extends", "is", "as",
+                             "true", "false"}) {
+        rules.push_back(Lexer::keyword(word, Symbol(word, true)));
+    }
+
+    // Operadores y signos de puntuacion
+    for (const char* op : {"+", "-", "*", "/", "^", "%", "**", "@", "@@",
+                           "==", "!=", "<", ">", "<=", ">=", "&", "|", "!",
+                           "=", ":=", "=>", "(", ")", "{", "}", "[", "]",
+                           ",", ";", ".", ":"}) {
+        rules.push_back(Lexer::keyword(op, Symbol(op, true)));
+    }
+
+    rules.push_back(Lexer::token("[a-zA-Z_][a-zA-Z0-9_]*", Symbol("id", true)));
+    rules.push_back(Lexer::token("[0-9]+(\\.[0-9]+)?", Symbol("number", true)));
+    rules.push_back(Lexer::token("\"([^\"\\\\\n]|\\\\.)*\"", Symbol("string", true)));
+
+    rules.push_back(Lexer::skip("[ \t\r\n]+"));
+    rules.push_back(Lexer::skip("//[^\n]*"));
+
+    return rules;
+}
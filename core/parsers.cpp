@@ -6,95 +6,212 @@
 #include <algorithm>
 #include <stack>
 #include <stdexcept>
+#include <cstdint>
+#include <iomanip>
+#include <memory>
+#include <functional>
 
 
 
 //#include "grammar.cpp"
+//#include "lexer.cpp"
 
 using namespace std;
 
 /**
- * Calcula First para una sentencia alpha
+ * Calcula First para una sentencia alpha dada como rango de indices densos
  */
-ContainerSet computeLocalFirst(const unordered_map<Symbol, 
-                               ContainerSet>& firsts, 
-                               const Sentence& alpha) {
-    ContainerSet first_alpha;
+ContainerSet computeLocalFirst(const vector<ContainerSet>& firsts,
+                               const int* begin, const int* end) {
+    ContainerSet first_alpha(firsts.empty() ? 0 : firsts[0].getWidth());
+    
+    // Si todos los símbolos pueden derivar epsilon, añadir epsilon
+    bool all_can_derive_epsilon = true;
+    for (const int* it = begin; it != end; ++it) {
+        const ContainerSet& first_symbol = firsts[*it];
+        first_alpha.update(first_symbol);
+        if (!first_symbol.containsEpsilon()) {
+            all_can_derive_epsilon = false;
+            break;
+        }
+    }
     
-    if (alpha.isEpsilon()) {
+    first_alpha.clearEpsilon();
+    if (all_can_derive_epsilon) {
         first_alpha.setEpsilon();
-    } else {
-        for (const Symbol& symbol : alpha) {
-            auto it = firsts.find(symbol);
-            if (it != firsts.end()) {
-                first_alpha.update(it->second);
-                if (!it->second.containsEpsilon()) {
-                    break;
+    }
+    
+    return first_alpha;
+}
+
+/**
+ * Calcula First para una sentencia alpha
+ */
+ContainerSet computeLocalFirst(const Grammar& G,
+                               const vector<ContainerSet>& firsts, 
+                               const Sentence& alpha) {
+    vector<int> indices;
+    for (const Symbol& symbol : alpha) {
+        if (!symbol.isEpsilon()) indices.push_back(G.indexOf(symbol));
+    }
+    return computeLocalFirst(firsts, indices.data(), indices.data() + indices.size());
+}
+
+/**
+ * Digraph
+ *      Grafo dirigido en formato CSR (offsets + destinos) sobre indices densos
+ */
+struct Digraph {
+    vector<int> offset;
+    vector<int> target;
+
+    Digraph(int n_nodes, const vector<pair<int,int>>& edges)
+        : offset(n_nodes + 1, 0), target(edges.size()) {
+        for (const auto& e : edges) offset[e.first + 1]++;
+        for (int i = 0; i < n_nodes; ++i) offset[i + 1] += offset[i];
+        vector<int> fill(offset.begin(), offset.end() - 1);
+        for (const auto& e : edges) target[fill[e.first]++] = e.second;
+    }
+
+    int size() const { return (int)offset.size() - 1; }
+};
+
+/**
+ * Algoritmo Digraph de DeRemer y Pennello
+ *      Resuelve F(x) = F'(x) ∪ { F(y) | x R y } recorriendo el grafo una vez
+ *      (Tarjan): cada arista se propaga una sola vez y todos los nodos de una
+ *      componente fuertemente conexa terminan con el mismo conjunto.
+ *      sets contiene F' a la entrada y F a la salida. El epsilon no se propaga
+ */
+void solveDigraph(const Digraph& R, vector<ContainerSet>& sets) {
+    const int n = R.size();
+    const int INF = INT32_MAX;
+    vector<int> N(n, 0);
+    vector<int> scc_stack;
+    // Pila de llamadas explicita: nodo, proxima arista a visitar y profundidad
+    struct Frame { int node; int edge; int depth; };
+    vector<Frame> frames;
+
+    for (int root = 0; root < n; ++root) {
+        if (N[root] != 0) continue;
+
+        scc_stack.push_back(root);
+        N[root] = (int)scc_stack.size();
+        frames.push_back({root, R.offset[root], N[root]});
+
+        while (!frames.empty()) {
+            int x = frames.back().node;
+            int& e = frames.back().edge;
+
+            if (e < R.offset[x + 1]) {
+                int y = R.target[e];
+                if (N[y] == 0) {
+                    // Descender en y; al volver se hace la union x <- y
+                    scc_stack.push_back(y);
+                    N[y] = (int)scc_stack.size();
+                    frames.push_back({y, R.offset[y], N[y]});
+                    continue;
                 }
+                N[x] = min(N[x], N[y]);
+                sets[x].hardUpdate(sets[y], false);
+                ++e;
+                continue;
             }
-        }
-        
-        // Si todos los símbolos pueden derivar epsilon, añadir epsilon
-        bool all_can_derive_epsilon = true;
-        for (const Symbol& symbol : alpha) {
-            auto it = firsts.find(symbol);
-            if (it == firsts.end() || !it->second.containsEpsilon()) {
-                all_can_derive_epsilon = false;
-                break;
+
+            // Todas las aristas de x procesadas: cerrar componente si x es raiz
+            if (N[x] == frames.back().depth) {
+                while (true) {
+                    int top = scc_stack.back();
+                    scc_stack.pop_back();
+                    N[top] = INF;
+                    if (top == x) break;
+                    bool eps = sets[top].containsEpsilon();
+                    sets[top] = sets[x];
+                    sets[top].clearEpsilon();
+                    if (eps) sets[top].setEpsilon();
+                }
+            }
+            frames.pop_back();
+
+            // Volver al padre: terminar la arista que nos trajo hasta aqui
+            if (!frames.empty()) {
+                int parent = frames.back().node;
+                N[parent] = min(N[parent], N[x]);
+                sets[parent].hardUpdate(sets[x], false);
+                ++frames.back().edge;
             }
         }
-        
-        if (all_can_derive_epsilon) {
-            first_alpha.setEpsilon();
+    }
+}
+
+/**
+ * Calcula que simbolos derivan epsilon
+ *      Cada produccion lleva la cuenta de simbolos de su parte derecha que
+ *      aun no se sabe si son anulables; cuando llega a 0 la parte izquierda
+ *      pasa a ser anulable. Cada ocurrencia se visita una sola vez
+ */
+vector<bool> computeNullable(const Grammar& G) {
+    vector<bool> nullable(G.numSymbols(), false);
+    vector<int> remaining(G.numProductions());
+    vector<pair<int,int>> occurrences;   // (simbolo, produccion)
+    vector<int> worklist;
+
+    for (int p = 0; p < G.numProductions(); ++p) {
+        remaining[p] = G.rightSize(p);
+        for (const int* it = G.rightBegin(p); it != G.rightEnd(p); ++it) {
+            occurrences.push_back({*it, p});
+        }
+        if (remaining[p] == 0 && !nullable[G.leftIndex(p)]) {
+            nullable[G.leftIndex(p)] = true;
+            worklist.push_back(G.leftIndex(p));
         }
     }
-    
-    return first_alpha;
+    Digraph uses(G.numSymbols(), occurrences);
+
+    while (!worklist.empty()) {
+        int X = worklist.back();
+        worklist.pop_back();
+        for (int e = uses.offset[X]; e < uses.offset[X + 1]; ++e) {
+            int p = uses.target[e];
+            if (--remaining[p] == 0 && !nullable[G.leftIndex(p)]) {
+                nullable[G.leftIndex(p)] = true;
+                worklist.push_back(G.leftIndex(p));
+            }
+        }
+    }
+    return nullable;
 }
 
 /**
  * Algoritmo principal para calcular First(G) donde G es la Gramatica 
+ *      El resultado se indexa por el indice denso del simbolo en G.
+ *      Para X -> α Y β con α anulable, First(X) ⊇ First(Y): se construye
+ *      ese grafo de dependencias y se resuelve con solveDigraph
  */
-unordered_map<Symbol, ContainerSet> computeFirsts(const Grammar& G) {
-    unordered_map<Symbol, ContainerSet> firsts;
-    unordered_map<Sentence, ContainerSet> sentence_firsts;
-    
-    bool change = true;
+vector<ContainerSet> computeFirsts(const Grammar& G) {
+    vector<ContainerSet> firsts(G.numSymbols(), ContainerSet(G.numTerminals()));
+    vector<bool> nullable = computeNullable(G);
+    vector<pair<int,int>> edges;
     
     // Inicializar First(Vt) - cada terminal tiene como First a si mismo
-    for (const Symbol& terminal : G.getTerminals()) {
-        firsts[terminal] = ContainerSet(terminal);
+    // First(Vn) - cada no terminal empieza con conjunto vacio
+    for (int t = 0; t < G.numTerminals(); ++t) {
+        firsts[t].insert(t);
     }
     
-    // Inicializar First(Vn) - cada no terminal empieza con conjunto vacio
-    for (const Symbol& nonTerminal : G.getNonTerminals()) {
-        firsts[nonTerminal] = ContainerSet();
+    // Para cada producción X -> alpha, X depende del prefijo anulable de alpha
+    for (int p = 0; p < G.numProductions(); ++p) {
+        int X = G.leftIndex(p);
+        for (const int* it = G.rightBegin(p); it != G.rightEnd(p); ++it) {
+            if (*it != X) edges.push_back({X, *it});
+            if (!nullable[*it]) break;
+        }
     }
     
-    while (change) {
-        change = false;
-        
-        // Para cada producción X -> alpha
-        for (const Production& production : G.getProductions()) {
-            const Symbol& X = production.getLeft();
-            const Sentence& alpha = production.getRight();
-            
-            // Obtener First(X) actual
-            ContainerSet& first_X = firsts[X];
-            
-            // Inicializar First(alpha) si no existe
-            if (sentence_firsts.find(alpha) == sentence_firsts.end()) {
-                sentence_firsts[alpha] = ContainerSet();
-            }
-            ContainerSet& first_alpha = sentence_firsts[alpha];
-            
-            // Calcular First local de alpha
-            ContainerSet local_first = computeLocalFirst(firsts, alpha);
-            
-            // Actualizar First(alpha) y First(X)
-            change |= first_alpha.hardUpdate(local_first);
-            change |= first_X.hardUpdate(local_first);
-        }
+    solveDigraph(Digraph(G.numSymbols(), edges), firsts);
+    
+    for (int X = G.numTerminals(); X < G.numSymbols(); ++X) {
+        if (nullable[X]) firsts[X].setEpsilon();
     }
     
     return firsts;
@@ -102,105 +219,90 @@ unordered_map<Symbol, ContainerSet> computeFirsts(const Grammar& G) {
 
 
 /**
- * Algoritmo principal para calcular Follow(G)
- * Basado en las reglas:
- * 1. Follow(S) contiene $
- * 2. Para B -> αAβ: Follow(A) ∪= (First(β) - {ε})
- * 3. Para B -> αA o B -> αAβ donde ε ∈ First(β): Follow(A) ∪= Follow(B)
+ * Calcula Follow(G) y, de paso, First de cada sufijo de parte derecha
+ *      suffix_firsts[G.rightOffset(p) + i] = First(rhs(p)[i..]); el
+ *      epsilon de ese conjunto indica si el sufijo es anulable
  */
-unordered_map<Symbol, ContainerSet> computeFollows(const Grammar& G, 
-                                                   const unordered_map<Symbol, ContainerSet>& firsts) {
-    unordered_map<Symbol, ContainerSet> follows;
-    bool change = true;
-    
-    // Simbolo EOF (final de fichero)
-    Symbol EOF_SYMBOL("$", true);
+vector<ContainerSet> computeFollows(const Grammar& G,
+                                    const vector<ContainerSet>& firsts,
+                                    vector<ContainerSet>* suffix_firsts) {
+    vector<ContainerSet> follows(G.numSymbols(), ContainerSet(G.numTerminals()));
+    vector<pair<int,int>> edges;
     
-    // Inicializar Follow(Vn) - cada no terminal empieza con conjunto vacio
-    for (const Symbol& nonTerminal : G.getNonTerminals()) {
-        follows[nonTerminal] = ContainerSet();
+    if (suffix_firsts) {
+        suffix_firsts->assign(G.numPositions(), ContainerSet(G.numTerminals()));
     }
     
     // Follow(S) contiene $ (simbolo de inicio)
-    follows[G.getStartSymbol()].insert(EOF_SYMBOL);
+    follows[G.startIndex()].insert(G.eofIndex());
     
-
-    while (change) {
-        change = false;
+    // Un solo recorrido de derecha a izquierda por produccion X -> alpha:
+    // beta = First del sufijo ya recorrido
+    ContainerSet beta(G.numTerminals());
+    for (int p = 0; p < G.numProductions(); ++p) {
+        int X = G.leftIndex(p);
+        beta = ContainerSet(G.numTerminals());
+        beta.setEpsilon();
         
-        // Para cada producción X -> alpha
-        for (const Production& production : G.getProductions()) {
-            const Symbol& X = production.getLeft();
-            const Sentence& alpha = production.getRight();
+        for (int i = G.rightSize(p) - 1; i >= 0; --i) {
+            int Y = G.rightBegin(p)[i];
             
-            // Si la producción es epsilon, continuar
-            if (alpha.isEpsilon()) {
-                continue;
+            if (!G.isTerminalIndex(Y)) {
+                // Regla S1: Follow(Y) ∪= (First(β) - {ε})
+                follows[Y].hardUpdate(beta, false);
+                // Regla S2: Si ε ∈ First(β), entonces Follow(Y) ∪= Follow(X)
+                if (beta.containsEpsilon() && Y != X) {
+                    edges.push_back({Y, X});
+                }
             }
             
-            ContainerSet& follow_X = follows[X];
-            size_t n = alpha.size();
+            // beta = First(Y β)
+            if (firsts[Y].containsEpsilon()) {
+                bool nullable = beta.containsEpsilon();
+                beta.hardUpdate(firsts[Y], false);
+                if (!nullable) beta.clearEpsilon();
+            } else {
+                beta = firsts[Y];
+            }
             
-            // Recorrer todos los símbolos de la parte derecha
-            for (size_t i = 0; i < n; ++i) {
-                const Symbol& Y = alpha[i];
-                
-                // Solo procesamos no terminales
-                if (!Y.isNonTerminal()) {
-                    continue;
-                }
-                
-                ContainerSet& follow_Y = follows[Y];
-                
-                // Caso: X -> ζ Y β (hay símbolos después de Y)
-                if (i < n - 1) {
-                    // Crear la cadena β (símbolos después de Y)
-                    vector<Symbol> beta_symbols;
-                    for (size_t j = i + 1; j < n; ++j) {
-                        beta_symbols.push_back(alpha[j]);
-                    }
-                    Sentence beta(beta_symbols);
-                    
-                    // Calcular First(β)
-                    ContainerSet first_beta = computeLocalFirst(firsts, beta);
-                    
-                    // Regla S1: Follow(Y) ∪= (First(β) - {ε})
-                    ContainerSet first_beta_no_epsilon = first_beta - unordered_set<std::string>{EPSILON, "epsilon"};
-                    change |= follow_Y.hardUpdate(first_beta_no_epsilon);
-                    
-                    // Regla S2: Si ε ∈ First(β), entonces Follow(Y) ∪= Follow(X)
-                    if (first_beta.containsEpsilon()) {
-                        change |= follow_Y.hardUpdate(follow_X);
-                    }
-                }
-                // Caso: X -> ζ Y (Y es el ultimo simbolo)
-                else {
-                    // Regla S2: Follow(Y) ∪= Follow(X)
-                    change |= follow_Y.hardUpdate(follow_X);
-                }
+            if (suffix_firsts) {
+                (*suffix_firsts)[G.rightOffset(p) + i] = beta;
             }
         }
     }
     
+    solveDigraph(Digraph(G.numSymbols(), edges), follows);
+    
     return follows;
 }
 
+/**
+ * Algoritmo principal para calcular Follow(G)
+ * Basado en las reglas:
+ * 1. Follow(S) contiene $
+ * 2. Para B -> αAβ: Follow(A) ∪= (First(β) - {ε})
+ * 3. Para B -> αA o B -> αAβ donde ε ∈ First(β): Follow(A) ∪= Follow(B)
+ *
+ * La regla 3 define un grafo entre no terminales que se resuelve con
+ * solveDigraph en lugar de repetir pasadas hasta el punto fijo
+ */
+vector<ContainerSet> computeFollows(const Grammar& G, 
+                                    const vector<ContainerSet>& firsts) {
+    return computeFollows(G, firsts, nullptr);
+}
+
 /**
  * Funcion auxiliar para imprimir conjuntos First y Follow
  */
 void printFirstAndFollow(const Grammar& G,
-                        const unordered_map<Symbol, ContainerSet>& firsts,
-                        const unordered_map<Symbol, ContainerSet>& follows) {
+                        const vector<ContainerSet>& firsts,
+                        const vector<ContainerSet>& follows) {
     cout << "\n=== CONJUNTOS FIRST Y FOLLOW ===\n";
     
-    auto print_set = [](const ContainerSet& cs) {
+    auto print_set = [&G](const ContainerSet& cs) {
         cout << "{ ";
-        for (const auto& symbol : cs.getSymbols()) {
-            if (symbol.getName() == EPSILON) {
-                cout << "epsilon ";
-            } else {
-                cout << symbol.getName() << " ";
-            }
+        for (int t : cs) {
+            cout << G.symbolAt(t).getName() << " ";
         }
         if (cs.containsEpsilon()) {
             cout << "epsilon ";
@@ -209,39 +311,33 @@ void printFirstAndFollow(const Grammar& G,
     };
 
     cout << "Elementos de FIRST:\n";
-    for (const auto& pair : firsts) {
-        cout << "First(" << pair.first.getName() << ") = ";
-        print_set(pair.second);
+    for (int i = 0; i < G.numSymbols(); ++i) {
+        cout << "First(" << G.symbolAt(i).getName() << ") = ";
+        print_set(firsts[i]);
         cout << "\n";
     }
 
     cout << "\nElementos de FOLLOW:\n";
-    for (const auto& pair : follows) {
-        cout << "Follow(" << pair.first.getName() << ") = ";
-        print_set(pair.second);
+    for (int i = G.numTerminals(); i < G.numSymbols(); ++i) {
+        cout << "Follow(" << G.symbolAt(i).getName() << ") = ";
+        print_set(follows[i]);
         cout << "\n";
     }
 
     // print First 
     cout << "\nConjuntos FIRST:\n";
     for (const Symbol& nonTerminal : G.getNonTerminals()) {
-        auto it = firsts.find(nonTerminal);
-        if (it != firsts.end()) {
-            cout << "First(" << nonTerminal.getName() << ") = ";
-            print_set(it->second);
-            cout << "\n";
-        }
+        cout << "First(" << nonTerminal.getName() << ") = ";
+        print_set(firsts[G.indexOf(nonTerminal)]);
+        cout << "\n";
     }
     
     // print Follow 
     cout << "\nConjuntos FOLLOW:\n";
     for (const Symbol& nonTerminal : G.getNonTerminals()) {
-        auto it = follows.find(nonTerminal);
-        if (it != follows.end()) {
-            cout << "Follow(" << nonTerminal.getName() << ") = ";
-            print_set(it->second);
-            cout << "\n";
-        }
+        cout << "Follow(" << nonTerminal.getName() << ") = ";
+        print_set(follows[G.indexOf(nonTerminal)]);
+        cout << "\n";
     }
 }
 
@@ -252,233 +348,389 @@ void printFirstAndFollow(const Grammar& G,
 
 
 
-class ParsingTable {
+/**
+ * PackedTable
+ *      Matriz dispersa de enteros empaquetada por desplazamiento de filas
+ *      (comb vector): cada fila tiene un valor por defecto y sus celdas
+ *      distintas de el se guardan en next[base[fila] + columna], marcadas con
+ *      check[...] = columna. Las filas se acomodan de mayor a menor cantidad de
+ *      celdas en el primer desplazamiento libre, de modo que unas llenan los
+ *      huecos de otras; dos filas nunca comparten base, asi que la columna en
+ *      check basta para saber a quien pertenece la celda. Las filas iguales
+ *      (con el mismo defecto) se guardan una sola vez.
+ *      La consulta es O(1): una suma, una comparacion y dos lecturas
+ */
+class PackedTable {
+private:
+    int n_rows;
+    int n_cols;
+    vector<int32_t> base;
+    vector<int32_t> defaults;
+    vector<int32_t> next;
+    vector<int32_t> check;          // columna duena de la celda (-1 = libre)
+    int n_unique;
+
 public:
-    struct ParsingLL1_Pair_Hash {
-        size_t operator()(const pair<Symbol,Symbol>& p) const {
-            return hash<string>()(p.first.getName()) ^ (hash<string>()(p.second.getName()) << 1);
+    PackedTable() : n_rows(0), n_cols(0), n_unique(0) {}
+
+    /**
+     * @param cells Matriz densa por filas (n_rows x n_cols)
+     * @param row_defaults Valor por defecto de cada fila
+     */
+    PackedTable(const vector<int32_t>& cells, int n_rows, int n_cols, const vector<int32_t>& row_defaults)
+        : n_rows(n_rows), n_cols(n_cols), base(n_rows, 0), defaults(row_defaults), n_unique(0) {
+        // Filas unicas: misma clave = mismas celdas y mismo defecto
+        unordered_map<string, int> unique_of;
+        vector<int> representative;
+        vector<int> unique_row(n_rows);
+        for (int r = 0; r < n_rows; ++r) {
+            string key((const char*)(cells.data() + (size_t)r * n_cols), (size_t)n_cols * sizeof(int32_t));
+            key.append((const char*)&defaults[r], sizeof(int32_t));
+            auto it = unique_of.emplace(move(key), (int)representative.size()).first;
+            if (it->second == (int)representative.size()) representative.push_back(r);
+            unique_row[r] = it->second;
         }
-    };
+        n_unique = (int)representative.size();
 
-    // Diccionario: key (no terminal, terminal), value: producción
-    unordered_map<pair<Symbol, Symbol>, Production, ParsingLL1_Pair_Hash> TABLE;
-    Grammar G;
-    
-    ParsingTable(const Grammar& G) : G(G) {
-        buildTable();
+        // Columnas con valor propio de cada fila unica
+        vector<vector<int>> columns(n_unique);
+        for (int u = 0; u < n_unique; ++u) {
+            int r = representative[u];
+            for (int c = 0; c < n_cols; ++c) {
+                if (cells[(size_t)r * n_cols + c] != defaults[r]) columns[u].push_back(c);
+            }
+        }
+        vector<int> order(n_unique);
+        for (int u = 0; u < n_unique; ++u) order[u] = u;
+        stable_sort(order.begin(), order.end(), [&](int x, int y) { return columns[x].size() > columns[y].size(); });
+
+        vector<int32_t> unique_base(n_unique);
+        vector<bool> base_used;
+        for (int u : order) {
+            int r = representative[u];
+            int b = 0;
+            while (true) {
+                if (b >= (int)base_used.size() || !base_used[b]) {
+                    bool fits = true;
+                    for (int c : columns[u]) {
+                        size_t i = (size_t)b + c;
+                        if (i < check.size() && check[i] != -1) { fits = false; break; }
+                    }
+                    if (fits) break;
+                }
+                ++b;
+            }
+            if (b >= (int)base_used.size()) base_used.resize(b + 1, false);
+            base_used[b] = true;
+            unique_base[u] = b;
+
+            size_t needed = (size_t)b + n_cols;
+            if (check.size() < needed) {
+                check.resize(needed, -1);
+                next.resize(needed, 0);
+            }
+            for (int c : columns[u]) {
+                check[b + c] = c;
+                next[b + c] = cells[(size_t)r * n_cols + c];
+            }
+        }
+        // Relleno para que base + columna nunca se salga del arreglo
+        size_t total = (size_t)base_used.size() + n_cols;
+        if (check.size() < total) {
+            check.resize(total, -1);
+            next.resize(total, 0);
+        }
+        for (int r = 0; r < n_rows; ++r) base[r] = unique_base[unique_row[r]];
     }
 
-private:
-    void buildTable() {
-        auto first = computeFirsts(G);
-        auto follow = computeFollows(G, first);
-        
-        
+    int32_t get(int row, int col) const {
+        size_t i = (size_t)base[row] + col;
+        return check[i] == col ? next[i] : defaults[row];
     }
 
+    int32_t getDefault(int row) const { return defaults[row]; }
+    int numRows() const { return n_rows; }
+    int numColumns() const { return n_cols; }
+    int numUniqueRows() const { return n_unique; }
+    size_t numSlots() const { return next.size(); }
+
+    // Arreglos crudos, para guardar la tabla en un archivo (ver saveParseTables)
+    const vector<int32_t>& getBase() const { return base; }
+    const vector<int32_t>& getDefaults() const { return defaults; }
+    const vector<int32_t>& getNext() const { return next; }
+    const vector<int32_t>& getCheck() const { return check; }
+
+    size_t memoryBytes() const {
+        return (base.size() + defaults.size() + next.size() + check.size()) * sizeof(int32_t);
+    }
 };
 
 
+/**
+ * LL1Table
+ *      Tabla LL(1) plana: una fila por no terminal y una columna por terminal
+ *      (indices densos de la gramatica); cada celda guarda el indice de la
+ *      produccion a aplicar o ERROR.
+ *
+ *      compress() la pasa a un PackedTable: las celdas de error de una fila
+ *      con alternativa anulable pasan a usarla por defecto, las filas iguales
+ *      se guardan una sola vez y el resto se empaqueta por desplazamiento.
+ *      Con entradas por defecto el error se detecta mas tarde, al comparar
+ *      el siguiente terminal, pero siempre antes de consumirlo
+ */
+class LL1Table {
+public:
+    static constexpr int ERROR = -1;
+
+private:
+    int n_terminals;
+    int first_nonterminal;
+    int n_nonterminals;
+    vector<int32_t> cells;          // (A - first_nonterminal) * n_terminals + a
+
+    // Forma comprimida
+    bool compressed;
+    PackedTable packed;
+
+public:
+    LL1Table() : n_terminals(0), first_nonterminal(0), n_nonterminals(0), compressed(false) {}
+    LL1Table(const Grammar& G)
+        : n_terminals(G.numTerminals()), first_nonterminal(G.numTerminals()),
+          n_nonterminals(G.numNonTerminals()),
+          cells((size_t)G.numNonTerminals() * G.numTerminals(), ERROR),
+          compressed(false) {}
+
+    /**
+     * Produccion para TABLE[A, a] o ERROR
+     */
+    int get(int A, int a) const {
+        int row = A - first_nonterminal;
+        if (!compressed) {
+            return cells[(size_t)row * n_terminals + a];
+        }
+        return packed.get(row, a);
+    }
+
+    void set(int A, int a, int production) {
+        if (compressed) throw logic_error("No se puede modificar una tabla LL(1) comprimida");
+        cells[(size_t)(A - first_nonterminal) * n_terminals + a] = production;
+    }
+
+    /**
+     * Comprime la tabla
+     * @param defaults Produccion por defecto de cada no terminal (por indice
+     *        relativo al primer no terminal), o ERROR si no tiene
+     */
+    bool compress(const vector<int>& defaults) {
+        if (compressed) return true;
+
+        // Con produccion por defecto las celdas de error de la fila tambien la usan
+        vector<int32_t> filled = cells;
+        for (int row = 0; row < n_nonterminals; ++row) {
+            if (defaults[row] == ERROR) continue;
+            for (int a = 0; a < n_terminals; ++a) {
+                int32_t& cell = filled[(size_t)row * n_terminals + a];
+                if (cell == ERROR) cell = defaults[row];
+            }
+        }
+        packed = PackedTable(filled, n_nonterminals, n_terminals,
+                             vector<int32_t>(defaults.begin(), defaults.end()));
+
+        cells.clear();
+        cells.shrink_to_fit();
+        compressed = true;
+        return true;
+    }
 
+    bool isCompressed() const { return compressed; }
+    int numUniqueRows() const { return compressed ? packed.numUniqueRows() : n_nonterminals; }
 
+    /**
+     * Memoria ocupada por las celdas de la tabla (en bytes)
+     */
+    size_t memoryBytes() const {
+        return cells.size() * sizeof(int32_t) + (compressed ? packed.memoryBytes() : 0);
+    }
+};
 
 
 /**
- * Clase que implementa el parser LL(1)
+ * ParsingTable
+ *      Producto inmutable del analisis de una gramatica para LL(1): First,
+ *      Follow, First de cada sufijo, la tabla de prediccion y la lista completa
+ *      de conflictos. Se construye una vez y se comparte entre todos los
+ *      parsers que la necesiten (ver LL1Parser(shared_ptr<const ParsingTable>))
  */
-class LL1Parser {
+class ParsingTable {
+public:
+    /**
+     * Conflicto LL(1): varias producciones predichas para TABLE[A, a]
+     */
+    struct Conflict {
+        int nonterminal;
+        int terminal;
+        vector<int> productions;
+    };
+
 private:
     Grammar G;
-    // Tabla de parsing: TABLE[NonTerminal][Terminal] -> Production
-    unordered_map<Symbol, unordered_map<Symbol, Production>> TABLE;
-    unordered_map<Symbol, ContainerSet> firsts;
-    unordered_map<Symbol, ContainerSet> follows;
-    Symbol EOF_SYMBOL;
-    
+    vector<ContainerSet> firsts;
+    vector<ContainerSet> follows;
+    vector<ContainerSet> suffix_firsts;
+    // Tabla de parsing: TABLE[NonTerminal][Terminal] -> indice de produccion
+    LL1Table TABLE;
+    vector<Conflict> conflicts;
+
     /**
      * Construye la tabla de análisis LL(1)
+     *      Ante un conflicto la celda se queda con la primera produccion y el
+     *      conflicto se anota; asi se reportan todos en una sola pasada
      */
-    void buildParsingTable() {
+    void buildTable() {
         // Calcular conjuntos First y Follow
         firsts = computeFirsts(G);
-        follows = computeFollows(G, firsts);
+        follows = computeFollows(G, firsts, &suffix_firsts);
         
         // Inicializar tabla vacia
-        TABLE.clear();
+        TABLE = LL1Table(G);
+        unordered_map<long long, int> conflict_at;   // celda -> indice en conflicts
         
         // Para cada produccion A -> α
-        for (const Production& production : G.getProductions()) {
-             const Symbol& A = production.getLeft();
-             const Sentence& alpha = production.getRight();
+        for (int p = 0; p < G.numProductions(); ++p) {
+            int A = G.leftIndex(p);
             
             // Calcular conjunto de prediccion para la produccion
-            ContainerSet prediction_set = computePredictionSet(production);
+            ContainerSet prediction_set = computePredictionSet(p);
             
             // Para cada terminal a en Pred(A -> α)
-            for (const Symbol& terminal : prediction_set.getSymbols()) {
-                // Verificar si ya existe una entrada en M[A, a]
-                if (TABLE[A].find(terminal) != TABLE[A].end()) {
-                    throw runtime_error("La gramatica no es LL(1): conflicto en TABLE[" + 
-                                        A.getName() + ", " + terminal.getName() + "]");
+            for (int a : prediction_set) {
+                int current = TABLE.get(A, a);
+                if (current == LL1Table::ERROR) {
+                    TABLE.set(A, a, p);
+                    continue;
                 }
-                TABLE[A][terminal] = production;
-            }
-            
-            // Si epsilon está en el conjunto de prediccion
-            if (prediction_set.containsEpsilon()) {
-                // Para cada simbolo en Follow(A)
-                const ContainerSet& follow_A = follows[A];
-                for (const Symbol& follow_symbol : follow_A.getSymbols()) {
-                    if (TABLE[A].find(follow_symbol) != TABLE[A].end()) {
-                        throw runtime_error("La gramatica no es LL(1): conflicto en TABLE[" + 
-                                            A.getName() + ", " + follow_symbol.getName() + "]");
-                    }
-                    TABLE[A][follow_symbol] = production;
+                
+                // Ya existe una entrada en M[A, a]
+                long long cell = (long long)A * G.numTerminals() + a;
+                auto it = conflict_at.find(cell);
+                if (it == conflict_at.end()) {
+                    conflict_at[cell] = (int)conflicts.size();
+                    conflicts.push_back({A, a, {current, p}});
+                } else {
+                    conflicts[it->second].productions.push_back(p);
                 }
             }
         }
     }
     
+    /**
+     * Comprime la tabla usando como produccion por defecto de cada no
+     * terminal su alternativa anulable (si tiene)
+     */
+    void compressTable() {
+        vector<int> defaults(G.numNonTerminals(), LL1Table::ERROR);
+        for (int p = 0; p < G.numProductions(); ++p) {
+            if (firstOfRight(p).containsEpsilon()) {
+                defaults[G.leftIndex(p) - G.numTerminals()] = p;
+            }
+        }
+        TABLE.compress(defaults);
+    }
+
+public:
+    /**
+     * @param compressed Si es true la tabla se guarda en forma comprimida
+     */
+    ParsingTable(const Grammar& G, bool compressed = false) : G(G) {
+        buildTable();
+        if (compressed && conflicts.empty()) {
+            compressTable();
+        }
+    }
+    
+    /**
+     * First de la parte derecha de la produccion p
+     */
+    ContainerSet firstOfRight(int p) const {
+        if (G.rightSize(p) == 0) {
+            ContainerSet epsilon(G.numTerminals());
+            epsilon.setEpsilon();
+            return epsilon;
+        }
+        return suffix_firsts[G.rightOffset(p)];
+    }
+    
     /**
      * Calcula el conjunto de prediccion para una produccion A -> α
      */
-    ContainerSet computePredictionSet(const Production& production) {
-        const Symbol& A = production.getLeft();
-        const Sentence& alpha = production.getRight();
-        ContainerSet prediction_set;
+    ContainerSet computePredictionSet(int p) const {
+        int A = G.leftIndex(p);
+        
+        // Pred(A -> α) = First(α)
+        ContainerSet prediction_set = firstOfRight(p);
         
-        if (alpha.isEpsilon()) {
-            // Si α = ε, entonces Pred(A -> α) = Follow(A)
+        // Si ε ∈ First(α), entonces Pred(A -> α) = First(α) ∪ Follow(A)
+        // (si α = ε, entonces Pred(A -> α) = Follow(A))
+        if (prediction_set.containsEpsilon()) {
             prediction_set.update(follows[A]);
-        } else {
-            // Pred(A -> α) = First(α)
-            ContainerSet first_alpha = computeLocalFirst(firsts, alpha);
-            prediction_set.update(first_alpha);
-            
-            // Si ε ∈ First(α), entonces Pred(A -> α) = First(α) ∪ Follow(A)
-            if (first_alpha.containsEpsilon()) {
-                prediction_set.update(follows[A]);
-            }
         }
+        prediction_set.clearEpsilon();
         
         return prediction_set;
     }
     
-public:
+    const Grammar& getGrammar() const { return G; }
+    const vector<ContainerSet>& getFirsts() const { return firsts; }
+    const vector<ContainerSet>& getFollows() const { return follows; }
+    const LL1Table& getTable() const { return TABLE; }
+    const vector<Conflict>& getConflicts() const { return conflicts; }
+    
     /**
-     * Constructor del parser LL(1)
+     * Verifica si la gramática es LL(1)
      */
-    LL1Parser(const Grammar& grammar) 
-        : G(grammar), EOF_SYMBOL("$", true) {
-        buildParsingTable();
-    }
+    bool isLL1() const { return conflicts.empty(); }
     
     /**
-     * Realiza el análisis sintáctico de una cadena de entrada
-     * @param input Cadena de entrada terminada en EOF ($)
-     * @return Vector de producciones aplicadas en orden
+     * Descripcion de todos los conflictos, una linea por celda
      */
-    vector<Production> parse(const vector<Symbol>& input) {
-        vector<Production> output;
-        stack<Symbol> parsing_stack;
-        size_t cursor = 0;
-        
-        // Inicializar pila con EOF y símbolo inicial
-        parsing_stack.push(EOF_SYMBOL);
-        parsing_stack.push(G.getStartSymbol());
-        
-        while (!parsing_stack.empty()) {
-            Symbol top = parsing_stack.top();
-            parsing_stack.pop();
-            
-            // Verificar bounds del cursor
-            if (cursor >= input.size()) {
-                throw runtime_error("Entrada insuficiente durante el analisis");
-            }
-            
-            Symbol current_input = input[cursor];
-            
-            if (top.getName() == EPSILON || top.getName() == "epsilon") {
-                // Símbolo epsilon - no hacer nada
-                continue;
-            }
-            else if (top.isTerminal()) {
-                // Top es terminal
-                if (top == current_input) {
-                    if (top == EOF_SYMBOL) {
-                        // Análisis exitoso
-                        break;
-                    }
-                    cursor++;
-                } else {
-                    throw runtime_error("Error sintactico: esperado '" + top.getName() + 
-                                      "', encontrado '" + current_input.getName() + "'");
-                }
-            }
-            else {
-                // Top es no terminal
-                auto it_A = TABLE.find(top);
-                if (it_A == TABLE.end()) {
-                    throw runtime_error("No terminal no encontrado en tabla: " + top.getName());
-                }
-                
-                auto it_prod = it_A->second.find(current_input);
-                if (it_prod == it_A->second.end()) {
-                    throw runtime_error("Error sintactico: no hay entrada en TABLE[" + 
-                                      top.getName() + ", " + current_input.getName() + "]");
-                }
-                
-                Production production = it_prod->second;
-                output.push_back(production);
-                
-                // Expandir producción en la pila (en orden inverso)
-                const Sentence& right_side = production.getRight();
-                if (!right_side.isEpsilon()) {
-                    // Apilar símbolos en orden inverso
-                    for (int i = right_side.size() - 1; i >= 0; i--) {
-                        parsing_stack.push(right_side[i]);
-                    }
-                }
+    string conflictReport() const {
+        string report;
+        for (const Conflict& c : conflicts) {
+            report += "conflicto en TABLE[" + G.symbolAt(c.nonterminal).getName() + ", " +
+                      G.symbolAt(c.terminal).getName() + "]:";
+            for (int p : c.productions) {
+                report += " {" + G.getProductions()[p].toString() + "}";
             }
+            report += "\n";
         }
-        
-        return output;
+        return report;
     }
     
     /**
      * Imprime la tabla de análisis LL(1)
      */
-    void printParsingTable() const {
+    void print() const {
         cout << "\n=== TABLA DE ANALISIS LL(1) ===\n";
         
-        // Obtener todos los terminales para las columnas
-        unordered_set<Symbol> all_terminals = G.getTerminals();
-        all_terminals.insert(EOF_SYMBOL);
-        
-        // Imprimir encabezados
+        // Imprimir encabezados (todos los terminales, incluido $)
         cout << setw(12) << "TABLE[A,a]";
-        for (const Symbol& terminal : all_terminals) {
-            cout << setw(15) << terminal.getName();
+        for (int a = 0; a < G.numTerminals(); ++a) {
+            cout << setw(15) << G.symbolAt(a).getName();
         }
         cout << "\n";
         
         // Imprimir filas para cada no terminal
-        for (const Symbol& nonTerminal : G.getNonTerminals()) {
-            cout << setw(12) << nonTerminal.getName();
+        for (int A = G.numTerminals(); A < G.numSymbols(); ++A) {
+            cout << setw(12) << G.symbolAt(A).getName();
             
-            for (const Symbol& terminal : all_terminals) {
-                auto it_A = TABLE.find(nonTerminal);
-                if (it_A != TABLE.end()) {
-                    auto it_prod = it_A->second.find(terminal);
-                    if (it_prod != it_A->second.end()) {
-                        string prod_str = it_prod->second.toString();
-                        if (prod_str.length() > 14) {
-                            prod_str = prod_str.substr(0, 11) + "...";
-                        }
-                        cout << setw(15) << prod_str;
-                    } else {
-                        cout << setw(15) << "ERROR";
+            for (int a = 0; a < G.numTerminals(); ++a) {
+                int p = TABLE.get(A, a);
+                if (p != LL1Table::ERROR) {
+                    string prod_str = G.getProductions()[p].toString();
+                    if (prod_str.length() > 14) {
+                        prod_str = prod_str.substr(0, 11) + "...";
                     }
+                    cout << setw(15) << prod_str;
                 } else {
                     cout << setw(15) << "ERROR";
                 }
@@ -486,49 +738,1229 @@ public:
             cout << "\n";
         }
     }
-    
-    /**
-     * Verifica si la gramática es LL(1)
-     */
-    bool isLL1() const {
-        try {
-            // Si la construcción de la tabla fue exitosa, es LL(1)
-            return true;
-        } catch (const runtime_error&) {
-            return false;
-        }
-    }
-    
-    /**
-     * Imprime el resultado del análisis
-     */
-    void printParseResult(const vector<Production>& derivations) const {
-        cout << "\n=== DERIVACIONES APLICADAS ===\n";
-        for (size_t i = 0; i < derivations.size(); i++) {
-            cout << (i + 1) << ". " << derivations[i].toString() << "\n";
-        }
-    }
 };
 
 
+/**
+ * ParseListener
+ *      Recibe los eventos del analisis a medida que ocurren, sin materializar
+ *      la derivacion: cada terminal consumido y las producciones aplicadas.
+ *      Un parser descendente llama a onProduction al expandir (derivacion por
+ *      la izquierda, en preorden); uno ascendente llama a onReduce al reducir
+ *      (en postorden). ReductionOrder convierte lo primero en lo segundo.
+ *      Para entradas de Symbols el token solo trae kind y offset (la posicion
+ *      en el vector); con el lexer trae tambien largo y linea
+ */
+class ParseListener {
+public:
+    virtual ~ParseListener() = default;
+    virtual void onProduction(int production) {}
+    virtual void onReduce(int production) {}
+    virtual void onShift(int terminal, const Token& token) {}
+    virtual void onAccept() {}
+};
 
 
+/**
+ * ReductionOrder
+ *      Adapta los eventos de un parser descendente al orden de uno ascendente:
+ *      recuerda cuantos hijos le faltan a cada produccion expandida y la
+ *      reduce (onReduce) cuando se completa el ultimo. Asi un mismo listener
+ *      con acciones semanticas de abajo hacia arriba sirve para cualquier parser
+ */
+class ReductionOrder : public ParseListener {
+private:
+    const Grammar& G;
+    ParseListener& target;
+    vector<pair<int, int>> open;    // (produccion, hijos que faltan)
 
+    void childDone() {
+        while (!open.empty() && --open.back().second == 0) {
+            int p = open.back().first;
+            open.pop_back();
+            target.onReduce(p);
+        }
+    }
 
+public:
+    ReductionOrder(const Grammar& G, ParseListener& target) : G(G), target(target) {}
 
+    void onProduction(int p) override {
+        if (G.rightSize(p) == 0) {
+            target.onReduce(p);
+            childDone();
+        } else {
+            open.push_back({p, G.rightSize(p)});
+        }
+    }
 
+    void onShift(int terminal, const Token& token) override {
+        target.onShift(terminal, token);
+        childDone();
+    }
 
+    void onAccept() override {
+        open.clear();
+        target.onAccept();
+    }
+};
 
 
+/**
+ * ParseTree
+ *      Arbol de derivacion en un arena: todos los nodos en un vector y los
+ *      hijos de cada nodo contiguos, referenciados por indice. La raiz es el
+ *      nodo 0. Las hojas terminales guardan la posicion de su lexema en el
+ *      fuente (no lo copian)
+ */
+struct ParseNode {
+    int32_t symbol;         // indice denso en la gramatica
+    int32_t production;     // produccion aplicada (-1 en las hojas terminales)
+    int32_t first_child;
+    int32_t n_children;
+    uint32_t offset;        // solo terminales
+    uint32_t length;
+};
 
+class ParseTree {
+private:
+    const Grammar* G = nullptr;
+    vector<ParseNode> nodes;
+
+    void print(ostream& out, int node, int depth, string_view source) const {
+        const ParseNode& n = nodes[node];
+        out << string(2 * depth, ' ') << G->symbolAt(n.symbol).getName();
+        if (n.production < 0 && !source.empty()) {
+            out << " '" << source.substr(n.offset, n.length) << "'";
+        }
+        out << "\n";
+        for (int c = 0; c < n.n_children; ++c) {
+            print(out, n.first_child + c, depth + 1, source);
+        }
+    }
+
+    friend class ParseTreeBuilder;
+
+public:
+    const Grammar& getGrammar() const { return *G; }
+    const vector<ParseNode>& getNodes() const { return nodes; }
+    const ParseNode& node(int i) const { return nodes[i]; }
+    const ParseNode& root() const { return nodes[0]; }
+    int size() const { return (int)nodes.size(); }
+
+    /**
+     * @param source Fuente de los tokens, para imprimir el lexema de cada hoja
+     */
+    void print(ostream& out = cout, string_view source = string_view()) const {
+        if (!nodes.empty()) print(out, 0, 0, source);
+    }
+};
+
+
+/**
+ * ParseTreeBuilder
+ *      Listener que arma el ParseTree a partir de los eventos. Como el LL(1)
+ *      deriva por la izquierda, basta una pila con los nodos que faltan por
+ *      expandir o por recibir su token: es la misma pila del parser, pero
+ *      de nodos
+ */
+class ParseTreeBuilder : public ParseListener {
+private:
+    const Grammar& G;
+    ParseTree tree;
+    vector<int32_t> pending;
+
+public:
+    explicit ParseTreeBuilder(const Grammar& G) : G(G) {
+        reset();
+    }
+
+    /**
+     * Prepara un arbol nuevo que solo tiene la raiz (el simbolo inicial)
+     */
+    void reset() {
+        tree.G = &G;
+        tree.nodes.clear();
+        tree.nodes.push_back({G.startIndex(), -1, 0, 0, 0, 0});
+        pending.assign(1, 0);
+    }
+
+    void onProduction(int p) override {
+        int32_t node = pending.back();
+        pending.pop_back();
+
+        int32_t first = (int32_t)tree.nodes.size();
+        tree.nodes[node].production = p;
+        tree.nodes[node].first_child = first;
+        tree.nodes[node].n_children = G.rightSize(p);
+        for (const int* it = G.rightBegin(p); it != G.rightEnd(p); ++it) {
+            tree.nodes.push_back({*it, -1, 0, 0, 0, 0});
+        }
+        for (int32_t child = (int32_t)tree.nodes.size(); child-- > first; ) {
+            pending.push_back(child);
+        }
+    }
+
+    void onShift(int terminal, const Token& token) override {
+        ParseNode& leaf = tree.nodes[pending.back()];
+        pending.pop_back();
+        leaf.offset = token.offset;
+        leaf.length = token.length;
+    }
+
+    /**
+     * Entrega el arbol construido (el builder queda listo para otro analisis)
+     */
+    ParseTree take() {
+        ParseTree result = move(tree);
+        reset();
+        return result;
+    }
+};
 
-/*
-TODO ShiftReduce-Parser
-*/
 
 /*
-TODO SLR1-Parser(ShiftReduce-Parser)
-*/
+ * Entradas de los parsers: todas exponen current (indice denso del terminal
+ * actual, -1 si no pertenece a la gramatica, NO_INPUT si se acabo la
+ * entrada), advance(), token() y describe() para los mensajes de error.
+ * Symbols es cualquier tipo con indexOfId (Grammar o una tabla cargada de
+ * archivo, ver TableFile)
+ */
+
+// Indice de terminal cuando ya no quedan tokens en la entrada
+constexpr int NO_INPUT = -2;
+
+/**
+ * Entrada: vector de simbolos terminado en $
+ */
+template<typename Symbols>
+struct SymbolInput {
+    const Symbols& G;
+    const vector<Symbol>& input;
+    size_t cursor;
+    int current;
+
+    SymbolInput(const Symbols& G, const vector<Symbol>& input)
+        : G(G), input(input), cursor(0), current(at(0)) {}
+    int at(size_t i) const { return i < input.size() ? G.indexOfId(input[i].getId()) : NO_INPUT; }
+    void advance() { current = at(++cursor); }
+    Token token() const { return {input[cursor].getId(), (uint32_t)cursor, 0, 0}; }
+    string describe() const { return input[cursor].getName(); }
+};
+
+/**
+ * Entrada: TokenStream del lexer (los tipos son ids de la SymbolTable)
+ */
+template<typename Symbols>
+struct StreamInput {
+    const Symbols& G;
+    const TokenStream& tokens;
+    size_t cursor;
+    int current;
+
+    StreamInput(const Symbols& G, const TokenStream& tokens)
+        : G(G), tokens(tokens), cursor(0), current(at(0)) {}
+    int at(size_t i) const { return i < tokens.size() ? G.indexOfId(tokens.kind(i)) : NO_INPUT; }
+    void advance() { current = at(++cursor); }
+    Token token() const {
+        return {tokens.kind(cursor), tokens.offset(cursor), tokens.length(cursor), tokens.line(cursor)};
+    }
+    string describe() const {
+        return SymbolTable::instance().getName(tokens.kind(cursor)) + " '" + string(tokens.text(cursor)) +
+               "' (linea " + to_string(tokens.line(cursor)) + ")";
+    }
+};
+
+/**
+ * Entrada: tokens pedidos al lexer de a uno (el cursor guarda el lookahead)
+ */
+template<typename Symbols>
+struct CursorInput {
+    const Symbols& G;
+    LexerCursor& tokens;
+    int current;
+
+    CursorInput(const Symbols& G, LexerCursor& tokens)
+        : G(G), tokens(tokens), current(G.indexOfId(tokens.peek().kind)) {}
+    void advance() {
+        tokens.advance();
+        current = G.indexOfId(tokens.peek().kind);
+    }
+    const Token& token() const { return tokens.peek(); }
+    string describe() const {
+        const Token& token = tokens.peek();
+        return SymbolTable::instance().getName(token.kind) + " '" + string(tokens.text(token)) +
+               "' (linea " + to_string(token.line) + ")";
+    }
+};
+
+
+/**
+ * Ciclo del parser predictivo sobre cualquier entrada con current/advance/token/describe.
+ * Los eventos van a listener (cualquier tipo con los metodos de
+ * ParseListener) en vez de acumularse, asi la memoria solo depende de la pila.
+ * G y TABLE pueden ser la gramatica y su LL1Table o una tabla cargada de archivo
+ */
+template<typename Symbols, typename Table, typename Input, typename Listener>
+void runLL1(const Symbols& G, const Table& TABLE, Input& input, Listener& listener) {
+    vector<int> parsing_stack;
+    const int eof = G.eofIndex();
+
+    // Inicializar pila con EOF y símbolo inicial
+    parsing_stack.push_back(eof);
+    parsing_stack.push_back(G.startIndex());
+
+    while (!parsing_stack.empty()) {
+        int top = parsing_stack.back();
+        parsing_stack.pop_back();
+        int current = input.current;
+
+        if (G.isTerminalIndex(top)) {
+            // Top es terminal
+            if (top == current) {
+                if (top == eof) {
+                    // Análisis exitoso
+                    listener.onAccept();
+                    break;
+                }
+                listener.onShift(top, input.token());
+                input.advance();
+            } else {
+                if (current == NO_INPUT) {
+                    throw runtime_error("Entrada insuficiente durante el analisis");
+                }
+                throw runtime_error("Error sintactico: esperado '" + G.symbolAt(top).getName() + 
+                                  "', encontrado " + input.describe());
+            }
+        }
+        else {
+            // Top es no terminal
+            if (current < 0 || !G.isTerminalIndex(current)) {
+                if (current == NO_INPUT) {
+                    throw runtime_error("Entrada insuficiente durante el analisis");
+                }
+                throw runtime_error("Simbolo de entrada desconocido: " + input.describe());
+            }
+
+            int p = TABLE.get(top, current);
+            if (p == Table::ERROR) {
+                throw runtime_error("Error sintactico: no hay entrada en TABLE[" + 
+                                  G.symbolAt(top).getName() + ", " + G.symbolAt(current).getName() +
+                                  "], encontrado " + input.describe());
+            }
+
+            listener.onProduction(p);
+
+            // Expandir producción en la pila (en orden inverso)
+            for (const int* it = G.rightEnd(p); it != G.rightBegin(p); ) {
+                parsing_stack.push_back(*--it);
+            }
+        }
+    }
+}
+
+
+/**
+ * Clase que implementa el parser LL(1)
+ *      Trabaja sobre los indices densos de la gramatica: la tabla guarda
+ *      indices de produccion y la pila guarda indices de simbolo.
+ *      La ParsingTable se comparte: construir varios parsers sobre la misma
+ *      tabla no repite el calculo de First/Follow.
+ *      parse es const y reentrante (la pila es local a cada llamada), asi un
+ *      mismo parser sirve a varios hilos a la vez (ver BatchCompiler)
+ */
+class LL1Parser {
+private:
+    shared_ptr<const ParsingTable> table;
+    
+    static shared_ptr<const ParsingTable> checked(shared_ptr<const ParsingTable> table) {
+        if (!table->isLL1()) {
+            throw runtime_error("La gramatica no es LL(1):\n" + table->conflictReport());
+        }
+        return table;
+    }
+    
+public:
+    /**
+     * Constructor del parser LL(1)
+     * @param compressed Si es true la tabla se guarda en forma comprimida
+     */
+    LL1Parser(const Grammar& grammar, bool compressed = false) 
+        : LL1Parser(make_shared<const ParsingTable>(grammar, compressed)) {}
+    
+    /**
+     * Constructor a partir de una tabla ya construida (y compartida)
+     */
+    LL1Parser(shared_ptr<const ParsingTable> parsing_table)
+        : table(checked(parsing_table)) {}
+    
+    const ParsingTable& getParsingTable() const { return *table; }
+    
+private:
+    template<typename Input, typename Listener>
+    void run(Input& input, Listener& listener) const {
+        runLL1(table->getGrammar(), table->getTable(), input, listener);
+    }
+    
+    /**
+     * Solo guarda las producciones; los metodos no son virtuales para que
+     * run() los llame directamente
+     */
+    struct ProductionCollector {
+        const vector<Production>& productions;
+        vector<Production> output;
+        
+        void onProduction(int p) { output.push_back(productions[p]); }
+        void onShift(int, const Token&) {}
+        void onAccept() {}
+    };
+    
+    template<typename Input>
+    vector<Production> collect(Input& input) const {
+        ProductionCollector collector{table->getGrammar().getProductions(), {}};
+        run(input, collector);
+        return move(collector.output);
+    }
+    
+public:
+    /**
+     * Realiza el análisis sintáctico de una cadena de entrada
+     * @param input Cadena de entrada terminada en EOF ($)
+     * @return Vector de producciones aplicadas en orden
+     */
+    vector<Production> parse(const vector<Symbol>& input) const {
+        SymbolInput cursor(table->getGrammar(), input);
+        return collect(cursor);
+    }
+    
+    /**
+     * Analiza directamente la salida del lexer, sin convertirla a Symbols
+     * @param tokens Tokens terminados en $ (ver Lexer::scan)
+     */
+    vector<Production> parse(const TokenStream& tokens) const {
+        StreamInput cursor(table->getGrammar(), tokens);
+        return collect(cursor);
+    }
+    
+    /**
+     * Analiza pidiendo los tokens al lexer a medida que hacen falta
+     */
+    vector<Production> parse(LexerCursor& tokens) const {
+        CursorInput cursor(table->getGrammar(), tokens);
+        return collect(cursor);
+    }
+    
+    /**
+     * Igual que parse(LexerCursor&) pero sin guardar la derivacion: cada
+     * produccion aplicada se pasa a on_production. La memoria usada es la de
+     * la pila de analisis, no la del archivo
+     */
+    void parse(LexerCursor& tokens, const function<void(const Production&)>& on_production) const {
+        struct Callback : ParseListener {
+            const vector<Production>& productions;
+            const function<void(const Production&)>& on_production;
+            Callback(const vector<Production>& productions, const function<void(const Production&)>& f)
+                : productions(productions), on_production(f) {}
+            void onProduction(int p) override { on_production(productions[p]); }
+        } callback(table->getGrammar().getProductions(), on_production);
+        parse(tokens, callback);
+    }
+    
+    /**
+     * Analisis por eventos: listener recibe los indices de produccion y los
+     * tokens consumidos a medida que ocurren (ver ParseTreeBuilder)
+     */
+    void parse(const vector<Symbol>& input, ParseListener& listener) const {
+        SymbolInput cursor(table->getGrammar(), input);
+        run(cursor, listener);
+    }
+    
+    void parse(const TokenStream& tokens, ParseListener& listener) const {
+        StreamInput cursor(table->getGrammar(), tokens);
+        run(cursor, listener);
+    }
+    
+    void parse(LexerCursor& tokens, ParseListener& listener) const {
+        CursorInput cursor(table->getGrammar(), tokens);
+        run(cursor, listener);
+    }
+    
+    /**
+     * Imprime la tabla de análisis LL(1)
+     */
+    void printParsingTable() const {
+        table->print();
+    }
+    
+    /**
+     * Verifica si la gramática es LL(1)
+     */
+    bool isLL1() const {
+        return table->isLL1();
+    }
+    
+    /**
+     * Imprime el resultado del análisis
+     */
+    void printParseResult(const vector<Production>& derivations) const {
+        cout << "\n=== DERIVACIONES APLICADAS ===\n";
+        for (size_t i = 0; i < derivations.size(); i++) {
+            cout << (i + 1) << ". " << derivations[i].toString() << "\n";
+        }
+    }
+};
+
+
+
+
+
+
+
+
+
+
+
+
+
+/**
+ * LR0Automaton
+ *      Coleccion canonica de conjuntos de items LR(0) de la gramatica
+ *      aumentada con S' -> S.
+ *
+ *      Un item (p, punto) se numera como itemBase(p) + punto, con
+ *      itemBase(p) = rightOffset(p) + p (cada produccion ocupa rightSize(p) + 1
+ *      numeros); S' -> .S y S' -> S. son los dos numeros siguientes.
+ *      Cada estado se identifica por su kernel ordenado, que se interna en una
+ *      tabla hash; las clausuras no se guardan. Las transiciones (GOTO sobre
+ *      terminales y no terminales) forman una matriz densa estados x simbolos
+ */
+class LR0Automaton {
+public:
+    static constexpr int32_t NONE = -1;
+
+private:
+    Grammar G;
+    int n_items;
+    vector<int32_t> item_prod;          // item -> produccion
+    vector<int32_t> item_next;          // item -> simbolo despues del punto (NONE si es completo)
+    vector<vector<int32_t>> initial_items;  // no terminal -> items A -> .α
+
+    vector<int32_t> kernel_offset;      // kernel de s: kernel_items[kernel_offset[s] .. kernel_offset[s+1])
+    vector<int32_t> kernel_items;
+    vector<int32_t> transitions;        // s * numSymbols() + X -> estado (NONE si no hay)
+    vector<int32_t> reduction_offset;   // producciones completas en s (CSR, como el kernel)
+    vector<int32_t> reductions;
+    int32_t accept_state;
+
+    struct ItemSetHash {
+        size_t operator()(const vector<int32_t>& items) const {
+            size_t h = items.size();
+            for (int32_t item : items) h = h * 1000003u ^ (size_t)item;
+            return h;
+        }
+    };
+
+    void numberItems() {
+        n_items = G.numPositions() + G.numProductions();
+        item_prod.assign(n_items + 2, NONE);
+        item_next.assign(n_items + 2, NONE);
+        initial_items.assign(G.numSymbols(), {});
+        for (int p = 0; p < G.numProductions(); ++p) {
+            int base = itemBase(p);
+            for (int dot = 0; dot <= G.rightSize(p); ++dot) {
+                item_prod[base + dot] = p;
+                item_next[base + dot] = dot < G.rightSize(p) ? G.rightBegin(p)[dot] : NONE;
+            }
+            initial_items[G.leftIndex(p)].push_back(base);
+        }
+        item_next[augmentedStart()] = G.startIndex();
+    }
+
+    /**
+     * Clausura del kernel: agrega A -> .α por cada A despues de un punto.
+     * added marca los no terminales ya expandidos con el sello stamp
+     */
+    void closure(int s, vector<int32_t>& items, vector<int>& added, int stamp) const {
+        items.assign(kernel_items.begin() + kernel_offset[s], kernel_items.begin() + kernel_offset[s + 1]);
+        for (size_t i = 0; i < items.size(); ++i) {
+            int X = item_next[items[i]];
+            if (X == NONE || G.isTerminalIndex(X) || added[X] == stamp) continue;
+            added[X] = stamp;
+            items.insert(items.end(), initial_items[X].begin(), initial_items[X].end());
+        }
+    }
+
+    void build() {
+        const int n_symbols = G.numSymbols();
+        unordered_map<vector<int32_t>, int32_t, ItemSetHash> state_of;
+        vector<int32_t> items;
+        vector<int> added(n_symbols, -1);
+        vector<vector<int32_t>> bucket(n_symbols);
+        vector<int> touched;
+
+        auto intern = [&](vector<int32_t>& kernel) -> int32_t {
+            auto it = state_of.find(kernel);
+            if (it != state_of.end()) return it->second;
+            int32_t s = (int32_t)kernel_offset.size() - 1;
+            state_of.emplace(kernel, s);
+            kernel_items.insert(kernel_items.end(), kernel.begin(), kernel.end());
+            kernel_offset.push_back((int32_t)kernel_items.size());
+            transitions.resize(transitions.size() + n_symbols, NONE);
+            return s;
+        };
+
+        kernel_offset.assign(1, 0);
+        accept_state = NONE;
+        reduction_offset.assign(1, 0);
+        vector<int32_t> start_kernel = {augmentedStart()};
+        intern(start_kernel);
+
+        // Los estados se numeran en orden de descubrimiento: la cola es el propio contador
+        for (int s = 0; s < numStates(); ++s) {
+            closure(s, items, added, s);
+
+            for (int32_t item : items) {
+                int X = item_next[item];
+                if (X == NONE) {
+                    if (item == augmentedEnd()) accept_state = s;
+                    else reductions.push_back(item_prod[item]);
+                    continue;
+                }
+                if (bucket[X].empty()) touched.push_back(X);
+                bucket[X].push_back(item + 1);
+            }
+            reduction_offset.push_back((int32_t)reductions.size());
+
+            for (int X : touched) {
+                sort(bucket[X].begin(), bucket[X].end());
+                int32_t t = intern(bucket[X]);
+                transitions[(size_t)s * n_symbols + X] = t;
+                bucket[X].clear();
+            }
+            touched.clear();
+        }
+    }
+
+public:
+    LR0Automaton(const Grammar& G) : G(G) {
+        numberItems();
+        build();
+    }
+
+    const Grammar& getGrammar() const { return G; }
+    int numStates() const { return (int)kernel_offset.size() - 1; }
+    int numItems() const { return n_items + 2; }
+
+    int itemBase(int p) const { return G.rightOffset(p) + p; }
+    int augmentedStart() const { return n_items; }
+    int augmentedEnd() const { return n_items + 1; }
+    int itemProduction(int item) const { return item_prod[item]; }
+    int itemDot(int item) const { return item >= n_items ? item - n_items : item - itemBase(item_prod[item]); }
+    int itemNext(int item) const { return item_next[item]; }
+
+    int32_t gotoState(int s, int X) const { return transitions[(size_t)s * G.numSymbols() + X]; }
+    int32_t acceptState() const { return accept_state; }
+
+    const int32_t* kernelBegin(int s) const { return kernel_items.data() + kernel_offset[s]; }
+    const int32_t* kernelEnd(int s) const { return kernel_items.data() + kernel_offset[s + 1]; }
+
+    // Reducciones: las producciones completas de cada estado, numeradas globalmente
+    int numReductions() const { return (int)reductions.size(); }
+    int reductionBegin(int s) const { return reduction_offset[s]; }
+    int reductionEnd(int s) const { return reduction_offset[s + 1]; }
+    int reductionProduction(int r) const { return reductions[r]; }
+
+    /**
+     * Clausura completa del estado s
+     */
+    vector<int32_t> closure(int s) const {
+        vector<int32_t> items;
+        vector<int> added(G.numSymbols(), -1);
+        closure(s, items, added, 0);
+        return items;
+    }
+
+    string itemToString(int item) const {
+        string left, right;
+        int dot = itemDot(item);
+        vector<int> symbols;
+        if (item >= n_items) {
+            left = G.getStartSymbol().getName() + "'";
+            symbols.push_back(G.startIndex());
+        } else {
+            int p = item_prod[item];
+            left = G.symbolAt(G.leftIndex(p)).getName();
+            symbols.assign(G.rightBegin(p), G.rightEnd(p));
+        }
+        for (size_t i = 0; i <= symbols.size(); ++i) {
+            if ((int)i == dot) right += " .";
+            if (i < symbols.size()) right += " " + G.symbolAt(symbols[i]).getName();
+        }
+        return left + " ->" + right;
+    }
+};
+
+
+/**
+ * Lookaheads SLR(1): la reduccion de A -> α se decide con Follow(A),
+ * en cualquier estado
+ */
+vector<ContainerSet> slrLookaheads(const LR0Automaton& automaton) {
+    const Grammar& G = automaton.getGrammar();
+    vector<ContainerSet> follows = computeFollows(G, computeFirsts(G));
+    vector<ContainerSet> lookaheads;
+    lookaheads.reserve(automaton.numReductions());
+    for (int r = 0; r < automaton.numReductions(); ++r) {
+        lookaheads.push_back(follows[G.leftIndex(automaton.reductionProduction(r))]);
+    }
+    return lookaheads;
+}
+
+
+/**
+ * Lookaheads LALR(1) por el metodo de DeRemer y Pennello, sobre el automata
+ * LR(0) y sin construir estados LR(1). Las incognitas son las transiciones
+ * por no terminal (p, A):
+ *      DR(p, A)    terminales que se pueden desplazar desde GOTO(p, A)
+ *                  (y $ si GOTO(p, A) es el estado que acepta)
+ *      reads       (p, A) reads (r, C) si r = GOTO(p, A), C anulable y existe GOTO(r, C)
+ *      includes    (p, A) includes (p', B) si B -> β A γ, γ anulable y p' --β--> p
+ *      Read = DR ∪ Read de los que lee; Follow = Read ∪ Follow de los que incluye
+ * Ambas uniones se resuelven con solveDigraph. Finalmente la reduccion de
+ * A -> ω en el estado q usa la union de Follow(p, A) para todo p --ω--> q.
+ * Coincide con fusionar los estados LR(1) si la gramatica no tiene simbolos
+ * improductivos (con ellos puede dar lookaheads de mas)
+ */
+vector<ContainerSet> lalrLookaheads(const LR0Automaton& automaton) {
+    const Grammar& G = automaton.getGrammar();
+    const int n_states = automaton.numStates();
+    const int n_terminals = G.numTerminals();
+    const int n_nonterminals = G.numNonTerminals();
+    vector<bool> nullable = computeNullable(G);
+
+    // Numerar las transiciones por no terminal; las de p son
+    // [first_transition[p], first_transition[p + 1])
+    vector<int> transition_of((size_t)n_states * n_nonterminals, -1);
+    vector<pair<int, int>> transitions;     // (p, A)
+    vector<int> first_transition(n_states + 1, 0);
+    for (int p = 0; p < n_states; ++p) {
+        first_transition[p] = (int)transitions.size();
+        for (int A = n_terminals; A < G.numSymbols(); ++A) {
+            if (automaton.gotoState(p, A) != LR0Automaton::NONE) {
+                transition_of[(size_t)p * n_nonterminals + (A - n_terminals)] = (int)transitions.size();
+                transitions.push_back({p, A});
+            }
+        }
+    }
+    first_transition[n_states] = (int)transitions.size();
+    auto transitionIndex = [&](int p, int A) {
+        return transition_of[(size_t)p * n_nonterminals + (A - n_terminals)];
+    };
+    const int n = (int)transitions.size();
+
+    // DR y reads
+    vector<ContainerSet> sets(n, ContainerSet(n_terminals));
+    vector<pair<int, int>> reads;
+    for (int x = 0; x < n; ++x) {
+        auto [p, A] = transitions[x];
+        int r = automaton.gotoState(p, A);
+        for (int a = 0; a < n_terminals; ++a) {
+            if (automaton.gotoState(r, a) != LR0Automaton::NONE) sets[x].insert(a);
+        }
+        if (r == automaton.acceptState()) sets[x].insert(G.eofIndex());
+        for (int y = first_transition[r]; y < first_transition[r + 1]; ++y) {
+            if (nullable[transitions[y].second]) reads.push_back({x, y});
+        }
+    }
+    solveDigraph(Digraph(n, reads), sets);
+
+    // includes y lookback, recorriendo cada produccion desde cada (p', B)
+    vector<pair<int, int>> includes;
+    vector<pair<int, int>> lookback;        // (reduccion, transicion)
+    vector<int> path;
+    for (int x = 0; x < n; ++x) {
+        auto [origin, B] = transitions[x];
+        for (const int* it_prod = G.productionsBegin(B); it_prod != G.productionsEnd(B); ++it_prod) {
+            int prod = *it_prod;
+            path.assign(1, origin);
+            for (const int* it = G.rightBegin(prod); it != G.rightEnd(prod); ++it) {
+                path.push_back(automaton.gotoState(path.back(), *it));
+            }
+
+            // Las posiciones con sufijo anulable, de derecha a izquierda
+            for (int i = G.rightSize(prod) - 1; i >= 0; --i) {
+                int X = G.rightBegin(prod)[i];
+                if (G.isTerminalIndex(X)) break;
+                includes.push_back({transitionIndex(path[i], X), x});
+                if (!nullable[X]) break;
+            }
+
+            int q = path.back();
+            for (int r = automaton.reductionBegin(q); r < automaton.reductionEnd(q); ++r) {
+                if (automaton.reductionProduction(r) == prod) {
+                    lookback.push_back({r, x});
+                    break;
+                }
+            }
+        }
+    }
+    solveDigraph(Digraph(n, includes), sets);
+
+    vector<ContainerSet> lookaheads(automaton.numReductions(), ContainerSet(n_terminals));
+    for (const auto& [r, x] : lookback) {
+        lookaheads[r].hardUpdate(sets[x], false);
+    }
+    return lookaheads;
+}
+
+
+/**
+ * Terminales con alguna accion en el estado de una tabla LR (para los mensajes de error)
+ */
+template<typename Symbols, typename Table>
+string expectedTerminals(const Symbols& G, const Table& TABLE, int state) {
+    string expected;
+    for (int a = 0; a < G.numTerminals(); ++a) {
+        if (TABLE.action(state, a) != 0) {
+            expected += (expected.empty() ? "'" : ", '") + G.symbolAt(a).getName() + "'";
+        }
+    }
+    return expected;
+}
+
+
+/**
+ * LRTable
+ *      Tablas ACTION y GOTO de un parser LR sobre un LR0Automaton. El tipo de
+ *      parser (SLR(1), LALR(1)) solo cambia los lookaheads de cada reduccion.
+ *
+ *      Una celda de ACTION es un entero: ERROR (0), desplazar al estado j
+ *      (j + 1), reducir por p (-(p + 1)) o ACCEPT. Ante un conflicto se
+ *      desplaza antes que reducir y se reduce por la produccion de menor
+ *      indice; todos los conflictos se anotan.
+ *
+ *      compress() pasa ambas tablas a PackedTable. En ACTION cada estado
+ *      reduce por defecto con su reduccion mas frecuente (tambien en las
+ *      celdas de error: el error se detecta despues de esas reducciones, pero
+ *      antes de desplazar). GOTO se empaqueta por columnas con el destino mas
+ *      frecuente de cada no terminal como defecto, porque nunca se consulta
+ *      una celda vacia de GOTO
+ */
+class LRTable {
+public:
+    static constexpr int32_t ERROR = 0;
+    static constexpr int32_t ACCEPT = INT32_MAX;
+
+    static int32_t shift(int state) { return state + 1; }
+    static int32_t reduce(int production) { return -(production + 1); }
+    static bool isShift(int32_t action) { return action > 0 && action != ACCEPT; }
+    static bool isReduce(int32_t action) { return action < 0; }
+    static int shiftTarget(int32_t action) { return action - 1; }
+    static int reducedProduction(int32_t action) { return -action - 1; }
+
+    /**
+     * Conflicto LR: varias acciones para ACTION[estado, a]
+     */
+    struct Conflict {
+        int state;
+        int terminal;
+        vector<int32_t> actions;
+    };
+
+private:
+    shared_ptr<const LR0Automaton> automaton;
+    string kind;
+    int n_states;
+    int n_terminals;
+    int n_nonterminals;
+    vector<int32_t> actions;        // s * n_terminals + a
+    vector<int32_t> gotos;          // s * n_nonterminals + (A - n_terminals)
+    vector<Conflict> conflicts;
+
+    // Forma comprimida
+    bool compressed;
+    PackedTable packed_actions;     // fila = estado
+    PackedTable packed_gotos;       // fila = no terminal, columna = estado
+
+    static int priority(int32_t action) {
+        // Mayor es mejor: aceptar, desplazar, reducir por la produccion menor
+        if (action == ACCEPT) return INT32_MAX;
+        if (isShift(action)) return INT32_MAX - 1;
+        return action;
+    }
+
+    void setAction(int s, int a, int32_t action, unordered_map<long long, int>& conflict_at) {
+        int32_t& cell = actions[(size_t)s * n_terminals + a];
+        if (cell == ERROR || cell == action) {
+            cell = action;
+            return;
+        }
+
+        long long key = (long long)s * n_terminals + a;
+        auto it = conflict_at.find(key);
+        if (it == conflict_at.end()) {
+            conflict_at[key] = (int)conflicts.size();
+            conflicts.push_back({s, a, {cell, action}});
+        } else {
+            conflicts[it->second].actions.push_back(action);
+        }
+        if (priority(action) > priority(cell)) cell = action;
+    }
+
+    static string actionToString(int32_t action) {
+        if (action == ACCEPT) return "acc";
+        if (isShift(action)) return "s" + to_string(shiftTarget(action));
+        if (isReduce(action)) return "r" + to_string(reducedProduction(action));
+        return "";
+    }
+
+public:
+    /**
+     * @param lookaheads Terminales de cada reduccion del automata (ver
+     *        LR0Automaton::reductionProduction), p. ej. slrLookaheads
+     * @param kind Nombre del metodo, para los mensajes
+     */
+    LRTable(shared_ptr<const LR0Automaton> automaton, const vector<ContainerSet>& lookaheads,
+            const string& kind)
+        : automaton(automaton), kind(kind), compressed(false) {
+        const Grammar& G = automaton->getGrammar();
+        n_states = automaton->numStates();
+        n_terminals = G.numTerminals();
+        n_nonterminals = G.numNonTerminals();
+        actions.assign((size_t)n_states * n_terminals, ERROR);
+        gotos.assign((size_t)n_states * n_nonterminals, LR0Automaton::NONE);
+        unordered_map<long long, int> conflict_at;
+
+        for (int s = 0; s < n_states; ++s) {
+            for (int a = 0; a < n_terminals; ++a) {
+                int32_t t = automaton->gotoState(s, a);
+                if (t != LR0Automaton::NONE) setAction(s, a, shift(t), conflict_at);
+            }
+            for (int A = n_terminals; A < G.numSymbols(); ++A) {
+                gotos[(size_t)s * n_nonterminals + (A - n_terminals)] = automaton->gotoState(s, A);
+            }
+            for (int r = automaton->reductionBegin(s); r < automaton->reductionEnd(s); ++r) {
+                for (int a : lookaheads[r]) {
+                    setAction(s, a, reduce(automaton->reductionProduction(r)), conflict_at);
+                }
+            }
+        }
+        if (automaton->acceptState() != LR0Automaton::NONE) {
+            setAction(automaton->acceptState(), G.eofIndex(), ACCEPT, conflict_at);
+        }
+    }
+
+    int32_t action(int state, int terminal) const {
+        if (!compressed) return actions[(size_t)state * n_terminals + terminal];
+        return packed_actions.get(state, terminal);
+    }
+    int32_t gotoState(int state, int nonterminal) const {
+        if (!compressed) return gotos[(size_t)state * n_nonterminals + (nonterminal - n_terminals)];
+        return packed_gotos.get(nonterminal - n_terminals, state);
+    }
+
+    /**
+     * Empaqueta ACTION (con reducciones por defecto) y GOTO
+     */
+    void compress() {
+        if (compressed) return;
+
+        vector<int32_t> action_defaults(n_states, ERROR);
+        unordered_map<int32_t, int> count;
+        for (int s = 0; s < n_states; ++s) {
+            count.clear();
+            int best = 0;
+            for (int a = 0; a < n_terminals; ++a) {
+                int32_t action = actions[(size_t)s * n_terminals + a];
+                if (!isReduce(action)) continue;
+                int c = ++count[action];
+                if (c > best || (c == best && action > action_defaults[s])) {
+                    best = c;
+                    action_defaults[s] = action;
+                }
+            }
+            // Las celdas de error del estado pasan a ser la reduccion por defecto
+            if (action_defaults[s] == ERROR) continue;
+            for (int a = 0; a < n_terminals; ++a) {
+                int32_t& cell = actions[(size_t)s * n_terminals + a];
+                if (cell == ERROR) cell = action_defaults[s];
+            }
+        }
+        packed_actions = PackedTable(actions, n_states, n_terminals, action_defaults);
+
+        vector<int32_t> by_column((size_t)n_nonterminals * n_states);
+        vector<int32_t> goto_defaults(n_nonterminals, LR0Automaton::NONE);
+        unordered_map<int32_t, int> targets;
+        for (int A = 0; A < n_nonterminals; ++A) {
+            targets.clear();
+            int best = 0;
+            for (int s = 0; s < n_states; ++s) {
+                int32_t t = gotos[(size_t)s * n_nonterminals + A];
+                if (t == LR0Automaton::NONE) continue;
+                int c = ++targets[t];
+                if (c > best) {
+                    best = c;
+                    goto_defaults[A] = t;
+                }
+            }
+            // Las celdas vacias toman el defecto: asi no ocupan lugar en el empaquetado
+            for (int s = 0; s < n_states; ++s) {
+                int32_t t = gotos[(size_t)s * n_nonterminals + A];
+                by_column[(size_t)A * n_states + s] = t == LR0Automaton::NONE ? goto_defaults[A] : t;
+            }
+        }
+        packed_gotos = PackedTable(by_column, n_nonterminals, n_states, goto_defaults);
+
+        actions.clear();
+        actions.shrink_to_fit();
+        gotos.clear();
+        gotos.shrink_to_fit();
+        compressed = true;
+    }
+
+    bool isCompressed() const { return compressed; }
+
+    const Grammar& getGrammar() const { return automaton->getGrammar(); }
+    const LR0Automaton& getAutomaton() const { return *automaton; }
+    const string& getKind() const { return kind; }
+    int numStates() const { return n_states; }
+    const vector<Conflict>& getConflicts() const { return conflicts; }
+    bool hasConflicts() const { return !conflicts.empty(); }
+
+    size_t memoryBytes() const {
+        return (actions.size() + gotos.size()) * sizeof(int32_t) +
+               (compressed ? packed_actions.memoryBytes() + packed_gotos.memoryBytes() : 0);
+    }
+
+    /**
+     * Descripcion de todos los conflictos, con los items del estado
+     */
+    string conflictReport() const {
+        const Grammar& G = getGrammar();
+        string report;
+        for (const Conflict& c : conflicts) {
+            bool shift_reduce = false;
+            for (int32_t action : c.actions) shift_reduce |= isShift(action);
+            report += string(shift_reduce ? "conflicto desplazar-reducir" : "conflicto reducir-reducir") +
+                      " en ACTION[" + to_string(c.state) + ", " + G.symbolAt(c.terminal).getName() + "]:";
+            for (int32_t action : c.actions) {
+                if (isReduce(action)) report += " {" + G.getProductions()[reducedProduction(action)].toString() + "}";
+                else report += " {" + actionToString(action) + "}";
+            }
+            report += "\n";
+            for (int32_t item : automaton->closure(c.state)) {
+                report += "    " + automaton->itemToString(item) + "\n";
+            }
+        }
+        return report;
+    }
+
+    /**
+     * Terminales con alguna accion en el estado (para los mensajes de error)
+     */
+    string expectedTerminals(int state) const {
+        return ::expectedTerminals(getGrammar(), *this, state);
+    }
+
+    void print() const {
+        const Grammar& G = getGrammar();
+        cout << "\n=== TABLA " << kind << " (" << n_states << " estados) ===\n";
+        cout << setw(6) << "estado";
+        for (int X = 0; X < G.numSymbols(); ++X) {
+            cout << setw(7) << G.symbolAt(X).getName();
+        }
+        cout << "\n";
+        for (int s = 0; s < n_states; ++s) {
+            cout << setw(6) << s;
+            for (int a = 0; a < n_terminals; ++a) {
+                cout << setw(7) << actionToString(action(s, a));
+            }
+            for (int A = n_terminals; A < G.numSymbols(); ++A) {
+                int32_t t = gotoState(s, A);
+                cout << setw(7) << (t == LR0Automaton::NONE ? "" : to_string(t));
+            }
+            cout << "\n";
+        }
+    }
+};
+
+
+/**
+ * Ciclo del parser LR: la pila guarda solo estados. G y TABLE pueden ser
+ * la gramatica y su LRTable o una tabla cargada de archivo
+ */
+template<typename Symbols, typename Table, typename Input, typename Listener>
+void runLR(const Symbols& G, const Table& TABLE, Input& input, Listener& listener) {
+    vector<int32_t> states;
+    states.push_back(0);
+
+    while (true) {
+        int current = input.current;
+        if (current < 0 || !G.isTerminalIndex(current)) {
+            if (current == NO_INPUT) {
+                throw runtime_error("Entrada insuficiente durante el analisis");
+            }
+            throw runtime_error("Simbolo de entrada desconocido: " + input.describe());
+        }
+
+        int32_t action = TABLE.action(states.back(), current);
+        if (LRTable::isShift(action)) {
+            listener.onShift(current, input.token());
+            input.advance();
+            states.push_back(LRTable::shiftTarget(action));
+        } else if (LRTable::isReduce(action)) {
+            int p = LRTable::reducedProduction(action);
+            states.resize(states.size() - G.rightSize(p));
+            listener.onReduce(p);
+            states.push_back(TABLE.gotoState(states.back(), G.leftIndex(p)));
+        } else if (action == LRTable::ACCEPT) {
+            listener.onAccept();
+            return;
+        } else {
+            throw runtime_error("Error sintactico: encontrado " + input.describe() +
+                                ", se esperaba uno de: " + expectedTerminals(G, TABLE, states.back()));
+        }
+    }
+}
+
+
+/**
+ * ShiftReduceParser
+ *      Parser LR dirigido por tabla: la pila guarda solo estados (enteros).
+ *      Emite onShift y onReduce en el orden de una derivacion por la derecha
+ *      invertida; parse(...) devuelve las producciones en ese mismo orden
+ */
+class ShiftReduceParser {
+protected:
+    shared_ptr<const LRTable> table;
+
+    static shared_ptr<const LRTable> checked(shared_ptr<const LRTable> table) {
+        if (table->hasConflicts()) {
+            throw runtime_error("La gramatica no es " + table->getKind() + ":\n" + table->conflictReport());
+        }
+        return table;
+    }
+
+    template<typename Input, typename Listener>
+    void run(Input& input, Listener& listener) const {
+        runLR(table->getGrammar(), *table, input, listener);
+    }
+
+    struct ReductionCollector {
+        const vector<Production>& productions;
+        vector<Production> output;
+
+        void onProduction(int) {}
+        void onReduce(int p) { output.push_back(productions[p]); }
+        void onShift(int, const Token&) {}
+        void onAccept() {}
+    };
+
+    template<typename Input>
+    vector<Production> collect(Input& input) const {
+        ReductionCollector collector{table->getGrammar().getProductions(), {}};
+        run(input, collector);
+        return move(collector.output);
+    }
+
+public:
+    /**
+     * @throws runtime_error con el reporte de conflictos si la tabla tiene alguno
+     */
+    ShiftReduceParser(shared_ptr<const LRTable> parsing_table) : table(checked(parsing_table)) {}
+    virtual ~ShiftReduceParser() = default;
+
+    const LRTable& getTable() const { return *table; }
+    shared_ptr<const LRTable> getSharedTable() const { return table; }
+
+    /**
+     * @return Producciones en el orden en que se reducen
+     */
+    vector<Production> parse(const vector<Symbol>& input) const {
+        SymbolInput cursor(table->getGrammar(), input);
+        return collect(cursor);
+    }
+
+    vector<Production> parse(const TokenStream& tokens) const {
+        StreamInput cursor(table->getGrammar(), tokens);
+        return collect(cursor);
+    }
+
+    vector<Production> parse(LexerCursor& tokens) const {
+        CursorInput cursor(table->getGrammar(), tokens);
+        return collect(cursor);
+    }
+
+    void parse(const vector<Symbol>& input, ParseListener& listener) const {
+        SymbolInput cursor(table->getGrammar(), input);
+        run(cursor, listener);
+    }
+
+    void parse(const TokenStream& tokens, ParseListener& listener) const {
+        StreamInput cursor(table->getGrammar(), tokens);
+        run(cursor, listener);
+    }
+
+    void parse(LexerCursor& tokens, ParseListener& listener) const {
+        CursorInput cursor(table->getGrammar(), tokens);
+        run(cursor, listener);
+    }
+
+    void printParsingTable() const {
+        table->print();
+    }
+
+    void printParseResult(const vector<Production>& reductions) const {
+        cout << "\n=== REDUCCIONES APLICADAS ===\n";
+        for (size_t i = 0; i < reductions.size(); i++) {
+            cout << (i + 1) << ". " << reductions[i].toString() << "\n";
+        }
+    }
+};
+
+
+/**
+ * SLR1Parser
+ *      ShiftReduceParser con lookaheads SLR(1) (Follow del lado izquierdo).
+ *      Acepta gramaticas recursivas por la izquierda, p. ej. E -> E + T | T
+ */
+class SLR1Parser : public ShiftReduceParser {
+public:
+    /**
+     * @param compressed Si es true las tablas se guardan empaquetadas (ver LRTable::compress)
+     */
+    static shared_ptr<const LRTable> buildTable(const Grammar& G, bool compressed = false) {
+        auto automaton = make_shared<const LR0Automaton>(G);
+        auto table = make_shared<LRTable>(automaton, slrLookaheads(*automaton), "SLR(1)");
+        if (compressed && !table->hasConflicts()) table->compress();
+        return table;
+    }
+
+    SLR1Parser(const Grammar& G, bool compressed = false) : ShiftReduceParser(buildTable(G, compressed)) {}
+    SLR1Parser(shared_ptr<const LRTable> parsing_table) : ShiftReduceParser(parsing_table) {}
+};
+
+
+/**
+ * LALR1Parser
+ *      ShiftReduceParser con lookaheads LALR(1): mismos estados que SLR(1)
+ *      pero sin los conflictos que produce usar Follow completo
+ */
+class LALR1Parser : public ShiftReduceParser {
+public:
+    /**
+     * @param compressed Si es true las tablas se guardan empaquetadas (ver LRTable::compress)
+     */
+    static shared_ptr<const LRTable> buildTable(const Grammar& G, bool compressed = false) {
+        auto automaton = make_shared<const LR0Automaton>(G);
+        auto table = make_shared<LRTable>(automaton, lalrLookaheads(*automaton), "LALR(1)");
+        if (compressed && !table->hasConflicts()) table->compress();
+        return table;
+    }
+
+    LALR1Parser(const Grammar& G, bool compressed = false) : ShiftReduceParser(buildTable(G, compressed)) {}
+    LALR1Parser(shared_ptr<const LRTable> parsing_table) : ShiftReduceParser(parsing_table) {}
+};
 
 
 
@@ -608,6 +2040,98 @@ void test_LL1Parser() {
         vector<Production> result = parser.parse(input);
         parser.printParseResult(result);
         
+        // El mismo analisis por eventos, armando el arbol de derivacion
+        ParseTreeBuilder builder(grammar);
+        parser.parse(input, builder);
+        cout << "\nArbol de derivacion:\n";
+        builder.take().print();
+        
+    } catch (const exception& e) {
+        cout << "Error: " << e.what() << endl;
+    }
+}
+
+
+
+// SLR1 Parser
+void test_SLR1Parser() {
+    /**
+     * La gramatica original, sin factorizar:
+     * E -> E + T | T
+     * T -> T * F | F
+     * F -> ( E ) | id
+     */
+    Symbol E("E", false), T("T", false), F("F", false);
+    Symbol plus("+", true), times("*", true), open("(", true), close(")", true), id("id", true);
+
+    vector<Production> productions = {
+        Production(E, Sentence({E, plus, T})),
+        Production(E, Sentence({T})),
+        Production(T, Sentence({T, times, F})),
+        Production(T, Sentence({F})),
+        Production(F, Sentence({open, E, close})),
+        Production(F, Sentence({id}))
+    };
+    Grammar grammar({plus, times, open, close, id}, {E, T, F}, E, productions);
+
+    try {
+        SLR1Parser parser(grammar);
+        parser.printParsingTable();
+
+        // id * ( id + id ) $
+        vector<Symbol> input = {id, times, open, id, plus, id, close, Symbol("$", true)};
+        vector<Production> result = parser.parse(input);
+        parser.printParseResult(result);
+
+        // Un no terminal en la entrada se rechaza antes de consultar ACTION
+        try {
+            parser.parse(vector<Symbol>{id, plus, T, Symbol("$", true)});
+            cout << "Error: se acepto un no terminal en la entrada" << endl;
+        } catch (const runtime_error& e) {
+            cout << "id + T $: " << e.what() << endl;
+        }
+
+    } catch (const exception& e) {
+        cout << "Error: " << e.what() << endl;
+    }
+}
+
+
+
+// LALR1 Parser
+void test_LALR1Parser() {
+    /**
+     * Asignaciones con punteros: no es SLR(1) (Follow(R) contiene '=')
+     * S -> L = R | R
+     * L -> * R | id
+     * R -> L
+     */
+    Symbol S("S", false), L("L", false), R("R", false);
+    Symbol assign("=", true), star("*", true), id("id", true);
+
+    vector<Production> productions = {
+        Production(S, Sentence({L, assign, R})),
+        Production(S, Sentence({R})),
+        Production(L, Sentence({star, R})),
+        Production(L, Sentence({id})),
+        Production(R, Sentence({L}))
+    };
+    Grammar grammar({assign, star, id}, {S, L, R}, S, productions);
+
+    try {
+        SLR1Parser parser(grammar);
+    } catch (const exception& e) {
+        cout << e.what();
+    }
+
+    try {
+        LALR1Parser parser(grammar);
+        parser.printParsingTable();
+
+        // * id = id $
+        vector<Symbol> input = {star, id, assign, id, Symbol("$", true)};
+        parser.printParseResult(parser.parse(input));
+
     } catch (const exception& e) {
         cout << "Error: " << e.what() << endl;
     }
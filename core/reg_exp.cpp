@@ -0,0 +1,299 @@
+#include <iostream>
+#include <string>
+#include <bitset>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+//#include "automata.cpp"
+
+using namespace std;
+
+
+/**
+ * RegexParser
+ *      Analizador descendente recursivo de expresiones regulares que construye
+ *      el AFND por Thompson directamente en un NFABuilder.
+ *
+ *      Sintaxis soportada:
+ *          a|b         alternativa (una alternativa vacia representa epsilon)
+ *          ab          concatenacion
+ *          a* a+ a?    clausura, una o mas veces, opcional
+ *          (a)         agrupacion
+ *          [abc] [a-z] [^...]   clases de caracteres, rangos y negacion
+ *          .           cualquier caracter salvo '\n'
+ *          \n \t \r \f \v       escapes de control
+ *          \d \w \s (y \D \W \S) digitos, caracteres de palabra, espacios
+ *          \c          cualquier otro caracter c, literal
+ */
+class RegexParser {
+private:
+    const string& pattern;
+    size_t pos;
+    NFABuilder& builder;
+
+    [[noreturn]] void error(const string& message) const {
+        throw invalid_argument("Expresion regular invalida en la posicion " + to_string(pos) +
+                               " de \"" + pattern + "\": " + message);
+    }
+
+    bool atEnd() const { return pos >= pattern.size(); }
+    char peek() const { return pattern[pos]; }
+
+    static bitset<256> shorthand(char c) {
+        bitset<256> set;
+        switch (tolower((unsigned char)c)) {
+            case 'd':
+                for (int b = '0'; b <= '9'; ++b) set[b] = true;
+                break;
+            case 'w':
+                for (int b = 0; b < 256; ++b) set[b] = isalnum(b) || b == '_';
+                break;
+            case 's':
+                for (char b : string(" \t\n\r\f\v")) set[(unsigned char)b] = true;
+                break;
+        }
+        if (isupper((unsigned char)c)) set.flip();
+        return set;
+    }
+
+    static bool isShorthand(char c) {
+        return string("dDwWsS").find(c) != string::npos;
+    }
+
+    static char control(char c) {
+        switch (c) {
+            case 'n': return '\n';
+            case 't': return '\t';
+            case 'r': return '\r';
+            case 'f': return '\f';
+            case 'v': return '\v';
+            default: return c;
+        }
+    }
+
+    /**
+     * Lee un caracter (posiblemente escapado) dentro de una clase
+     */
+    char classChar() {
+        if (atEnd()) error("clase de caracteres sin cerrar");
+        char c = pattern[pos++];
+        if (c != '\\') return c;
+        if (atEnd()) error("escape incompleto");
+        char e = pattern[pos++];
+        if (e == '0') error("el caracter nulo esta reservado para epsilon");
+        return control(e);
+    }
+
+    NFABuilder::Fragment charClass() {
+        bitset<256> set;
+        bool negated = false;
+        if (!atEnd() && peek() == '^') {
+            negated = true;
+            ++pos;
+        }
+        // Un ']' al principio es literal
+        bool first = true;
+        while (true) {
+            if (atEnd()) error("clase de caracteres sin cerrar");
+            if (peek() == ']' && !first) break;
+            first = false;
+
+            if (peek() == '\\' && pos + 1 < pattern.size() && isShorthand(pattern[pos + 1])) {
+                set |= shorthand(pattern[pos + 1]);
+                pos += 2;
+                continue;
+            }
+
+            unsigned char low = (unsigned char)classChar();
+            unsigned char high = low;
+            if (pos + 1 < pattern.size() && peek() == '-' && pattern[pos + 1] != ']') {
+                ++pos;
+                high = (unsigned char)classChar();
+                if (high < low) error("rango invertido");
+            }
+            for (int b = low; b <= high; ++b) set[b] = true;
+        }
+        ++pos;  // ']'
+
+        if (negated) set.flip();
+        set[0] = false;
+        if (set.none()) error("clase de caracteres vacia");
+        return builder.charSet(set);
+    }
+
+    NFABuilder::Fragment atom() {
+        char c = pattern[pos++];
+        switch (c) {
+            case '(': {
+                NFABuilder::Fragment inner = alternation();
+                if (atEnd() || peek() != ')') error("falta ')'");
+                ++pos;
+                return inner;
+            }
+            case '[':
+                return charClass();
+            case '.': {
+                bitset<256> any;
+                any.set();
+                any[0] = false;
+                any['\n'] = false;
+                return builder.charSet(any);
+            }
+            case '\\': {
+                if (atEnd()) error("escape incompleto");
+                char e = pattern[pos++];
+                if (isShorthand(e)) {
+                    bitset<256> set = shorthand(e);
+                    set[0] = false;
+                    return builder.charSet(set);
+                }
+                if (e == '0') error("el caracter nulo esta reservado para epsilon");
+                return builder.symbol(control(e));
+            }
+            case '*': case '+': case '?':
+                --pos;
+                error("operador sin operando");
+            case ')':
+                --pos;
+                error("')' sin '(' correspondiente");
+            default:
+                return builder.symbol(c);
+        }
+    }
+
+    NFABuilder::Fragment repetition() {
+        NFABuilder::Fragment f = atom();
+        while (!atEnd()) {
+            char c = peek();
+            if (c == '*') f = builder.closure(f);
+            else if (c == '+') f = builder.plus(f);
+            else if (c == '?') f = builder.optional(f);
+            else break;
+            ++pos;
+        }
+        return f;
+    }
+
+    NFABuilder::Fragment concatenation() {
+        if (atEnd() || peek() == '|' || peek() == ')') {
+            return builder.epsilon();
+        }
+        NFABuilder::Fragment f = repetition();
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            f = builder.concat(f, repetition());
+        }
+        return f;
+    }
+
+    NFABuilder::Fragment alternation() {
+        NFABuilder::Fragment f = concatenation();
+        while (!atEnd() && peek() == '|') {
+            ++pos;
+            f = builder.unite(f, concatenation());
+        }
+        return f;
+    }
+
+public:
+    RegexParser(const string& pattern, NFABuilder& builder)
+        : pattern(pattern), pos(0), builder(builder) {}
+
+    /**
+     * Analiza el patron completo y devuelve su fragmento dentro del builder
+     */
+    NFABuilder::Fragment parse() {
+        NFABuilder::Fragment f = alternation();
+        if (!atEnd()) error("')' sin '(' correspondiente");
+        return f;
+    }
+};
+
+
+/**
+ * Regex
+ *      Expresion regular compilada: AFND de Thompson -> AFD por subconjuntos ->
+ *      AFD minimo (numerado en BFS) -> DFATable. match() reconoce la cadena
+ *      completa recorriendo la tabla
+ */
+class Regex {
+private:
+    string pattern;
+    AFND nfa;
+    AFD dfa;
+    DFATable table;
+
+    static AFND thompson(const string& pattern) {
+        NFABuilder builder;
+        NFABuilder::Fragment f = RegexParser(pattern, builder).parse();
+        return builder.build(f);
+    }
+
+public:
+    /**
+     * @param max_dfa_states Limite de estados para la construccion de subconjuntos
+     */
+    Regex(const string& pattern, int max_dfa_states = 100000)
+        : pattern(pattern),
+          nfa(thompson(pattern)),
+          dfa(minimizeDFA(NFAtoDFA(nfa, max_dfa_states), true)),
+          table(dfa) {}
+
+    bool match(const char* data, size_t size) const { return table.recognize(data, size); }
+    bool match(const string& text) const { return table.recognize(text); }
+
+    const string& getPattern() const { return pattern; }
+    const AFND& getNFA() const { return nfa; }
+    const AFD& getDFA() const { return dfa; }
+    const DFATable& getTable() const { return table; }
+};
+
+
+/**
+ * Compila un patron reutilizando la compilacion anterior si ya se vio el
+ * mismo texto. La cache es global y segura entre hilos
+ */
+shared_ptr<const Regex> compileRegex(const string& pattern) {
+    static mutex cache_mutex;
+    static unordered_map<string, shared_ptr<const Regex>> cache;
+
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        auto it = cache.find(pattern);
+        if (it != cache.end()) return it->second;
+    }
+
+    // Se compila fuera del lock; si otro hilo gano la carrera se usa el suyo
+    auto compiled = make_shared<const Regex>(pattern);
+    lock_guard<mutex> lock(cache_mutex);
+    return cache.emplace(pattern, compiled).first->second;
+}
+
+
+
+
+
+
+
+
+
+// TEST
+// Regex
+void test_Regex() {
+    vector<pair<string, vector<string>>> cases = {
+        {"(a|b)*abb", {"abb", "aabb", "babb", "ab", "abba"}},
+        {"[a-zA-Z_]\\w*", {"x", "_tmp1", "print", "1x", ""}},
+        {"\\d+(\\.\\d+)?", {"42", "3.14", "3.", ".5"}},
+    };
+
+    for (const auto& [pattern, words] : cases) {
+        shared_ptr<const Regex> regex = compileRegex(pattern);
+        cout << "\n=== REGEX " << pattern << " ===\n";
+        cout << "AFND: " << regex->getNFA().getNumStates() << " estados, AFD minimo: "
+             << regex->getDFA().getNumStates() << " estados\n";
+        for (const string& word : words) {
+            cout << "  \"" << word << "\" -> " << (regex->match(word) ? "acepta" : "rechaza") << "\n";
+        }
+    }
+}
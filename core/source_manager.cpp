@@ -0,0 +1,346 @@
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define HULK_SOURCE_MMAP 1
+#endif
+
+using namespace std;
+
+
+using FileId = int32_t;
+
+
+/**
+ * SourceFile
+ *      Un archivo fuente cargado: su texto es una vista sobre un mmap (archivos
+ *      grandes) o sobre un buffer del pool de SourceManager (archivos chicos).
+ *      La tabla de comienzos de linea se calcula la primera vez que se pide
+ *      una linea; line y column no se deben llamar desde varios hilos a la vez
+ */
+class SourceFile {
+private:
+    friend class SourceManager;
+
+    FileId id;
+    string path;
+    string_view text;
+    void* mapping = nullptr;
+    size_t mapped_size = 0;
+    int buffer = -1;                        // indice en el pool (-1 = ninguno)
+    int users = 0;                          // load sin su release
+    mutex loading;
+    mutable vector<uint32_t> line_starts;
+
+    void computeLines() const {
+        line_starts.assign(1, 0);
+        const char* begin = text.data();
+        const char* end = begin + text.size();
+        for (const char* c = begin; (c = (const char*)memchr(c, '\n', end - c)); ++c) {
+            line_starts.push_back((uint32_t)(c - begin + 1));
+        }
+    }
+
+public:
+    SourceFile(FileId id, const string& path) : id(id), path(path) {}
+
+    FileId getId() const { return id; }
+    const string& getPath() const { return path; }
+    string_view getText() const { return text; }
+    bool isLoaded() const { return text.data() != nullptr; }
+    bool isMapped() const { return mapping != nullptr; }
+
+    /**
+     * Linea (desde 1) de una posicion del texto
+     */
+    uint32_t line(uint32_t offset) const {
+        if (line_starts.empty()) computeLines();
+        return (uint32_t)(upper_bound(line_starts.begin(), line_starts.end(), offset) - line_starts.begin());
+    }
+
+    /**
+     * Columna (desde 1) de una posicion del texto
+     */
+    uint32_t column(uint32_t offset) const {
+        return offset - line_starts[line(offset) - 1] + 1;
+    }
+
+    size_t numLines() const {
+        if (line_starts.empty()) computeLines();
+        return line_starts.size();
+    }
+};
+
+
+/**
+ * SourceManager
+ *      Carga de archivos fuente sin copias caracter a caracter:
+ *      - los archivos de al menos mmap_threshold bytes se proyectan con mmap
+ *        de solo lectura y madvise(MADV_SEQUENTIAL)
+ *      - los chicos se leen de una vez en un buffer del pool; al liberar el
+ *        archivo el buffer vuelve al pool para el siguiente
+ *      - el id de un archivo se asigna la primera vez que se pide su ruta
+ *      - prefetch pide al sistema que empiece a leer un archivo (readahead)
+ *        mientras se compila el anterior
+ *      Se puede usar desde varios hilos
+ */
+class SourceManager {
+private:
+    struct Buffer {
+        unique_ptr<char[]> data;
+        size_t capacity = 0;
+    };
+
+    size_t mmap_threshold;
+    mutable mutex lock;
+    vector<unique_ptr<SourceFile>> files;
+    unordered_map<string, FileId> id_of;
+    vector<Buffer> buffers;
+    vector<int> free_buffers;
+    size_t n_mapped = 0;
+
+    static constexpr size_t MIN_BUFFER = 64 * 1024;
+
+    /**
+     * Toma del pool un buffer de al menos size bytes
+     * @return El indice del buffer; su memoria queda en data
+     */
+    int acquireBuffer(size_t size, char*& data) {
+        lock_guard<mutex> guard(lock);
+        for (size_t i = 0; i < free_buffers.size(); ++i) {
+            int b = free_buffers[i];
+            if (buffers[b].capacity >= size) {
+                free_buffers.erase(free_buffers.begin() + i);
+                data = buffers[b].data.get();
+                return b;
+            }
+        }
+        // Ninguno alcanza: el ultimo devuelto al pool se reemplaza por uno mas
+        // grande (asi el pool no crece) o, si no hay libres, se crea uno nuevo
+        int b;
+        if (!free_buffers.empty()) {
+            b = free_buffers.back();
+            free_buffers.pop_back();
+        } else {
+            b = (int)buffers.size();
+            buffers.emplace_back();
+        }
+        size_t capacity = max(size, MIN_BUFFER);
+        buffers[b].data.reset(new char[capacity]);
+        buffers[b].capacity = capacity;
+        data = buffers[b].data.get();
+        return b;
+    }
+
+    [[noreturn]] static void openError(const string& path) {
+        throw runtime_error("No se pudo abrir el archivo " + path);
+    }
+
+    // Error a mitad de lectura: el buffer vuelve al pool, no se entrega texto truncado
+    [[noreturn]] void readError(SourceFile& file) {
+        unload(file);
+        throw runtime_error("No se pudo leer el archivo " + file.path);
+    }
+
+    void read(SourceFile& file) {
+#ifdef HULK_SOURCE_MMAP
+        int fd = ::open(file.path.c_str(), O_RDONLY);
+        if (fd < 0) openError(file.path);
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            openError(file.path);
+        }
+        size_t size = (size_t)info.st_size;
+
+        if (size >= mmap_threshold && size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, size, MADV_SEQUENTIAL);
+                ::close(fd);
+                file.mapping = p;
+                file.mapped_size = size;
+                file.text = string_view((const char*)p, size);
+                lock_guard<mutex> guard(lock);
+                ++n_mapped;
+                return;
+            }
+        }
+
+        char* data;
+        file.buffer = acquireBuffer(size, data);
+        size_t done = 0;
+        while (done < size) {
+            ssize_t n = ::read(fd, data + done, size - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            done += (size_t)n;
+        }
+        ::close(fd);
+        if (done < size) readError(file);
+        file.text = string_view(data, done);
+#else
+        ifstream in(file.path, ios::binary | ios::ate);
+        if (!in) openError(file.path);
+        size_t size = (size_t)in.tellg();
+        in.seekg(0);
+        char* data;
+        file.buffer = acquireBuffer(size, data);
+        in.read(data, (streamsize)size);
+        if ((size_t)in.gcount() < size) readError(file);
+        file.text = string_view(data, size);
+#endif
+    }
+
+    void unload(SourceFile& file) {
+        if (file.buffer >= 0) {
+            lock_guard<mutex> guard(lock);
+            free_buffers.push_back(file.buffer);
+        }
+#ifdef HULK_SOURCE_MMAP
+        if (file.mapping) munmap(file.mapping, file.mapped_size);
+#endif
+        file.mapping = nullptr;
+        file.mapped_size = 0;
+        file.buffer = -1;
+        file.text = string_view();
+        file.line_starts.clear();
+    }
+
+public:
+    /**
+     * @param mmap_threshold Tamano desde el que un archivo se proyecta en vez de leerse
+     */
+    explicit SourceManager(size_t mmap_threshold = 256 * 1024) : mmap_threshold(mmap_threshold) {}
+
+    ~SourceManager() {
+        for (auto& file : files) unload(*file);
+    }
+
+    SourceManager(const SourceManager&) = delete;
+    SourceManager& operator=(const SourceManager&) = delete;
+
+    /**
+     * Id del archivo (se asigna la primera vez, sin leerlo)
+     */
+    FileId getId(const string& path) {
+        lock_guard<mutex> guard(lock);
+        auto [it, added] = id_of.emplace(path, (FileId)files.size());
+        if (added) files.push_back(make_unique<SourceFile>(it->second, path));
+        return it->second;
+    }
+
+    /**
+     * Carga el archivo si no esta cargado. Cada load se corresponde con un
+     * release; el texto se libera con el ultimo
+     */
+    const SourceFile& load(FileId id) {
+        SourceFile* file;
+        {
+            lock_guard<mutex> guard(lock);
+            file = files[id].get();
+        }
+        lock_guard<mutex> guard(file->loading);
+        if (!file->isLoaded()) read(*file);
+        ++file->users;
+        return *file;
+    }
+
+    const SourceFile& load(const string& path) { return load(getId(path)); }
+
+    const SourceFile& get(FileId id) const {
+        lock_guard<mutex> guard(lock);
+        return *files[id];
+    }
+
+    /**
+     * Libera el texto del archivo (desproyecta o devuelve el buffer al pool);
+     * el id sigue valido y el archivo se puede volver a cargar
+     */
+    void release(FileId id) {
+        SourceFile* file;
+        {
+            lock_guard<mutex> guard(lock);
+            file = files[id].get();
+        }
+        lock_guard<mutex> guard(file->loading);
+        if (file->users > 0 && --file->users > 0) return;
+        unload(*file);
+    }
+
+    /**
+     * Pide al sistema que lea el archivo por adelantado; no bloquea
+     */
+    void prefetch(const string& path) const {
+#if defined(HULK_SOURCE_MMAP) && defined(POSIX_FADV_WILLNEED)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        ::close(fd);
+#else
+        (void)path;
+#endif
+    }
+
+    size_t numFiles() const {
+        lock_guard<mutex> guard(lock);
+        return files.size();
+    }
+
+    size_t numMapped() const {
+        lock_guard<mutex> guard(lock);
+        return n_mapped;
+    }
+
+    size_t numBuffers() const {
+        lock_guard<mutex> guard(lock);
+        return buffers.size();
+    }
+};
+
+
+
+
+
+
+
+
+// TEST
+// Carga de ./test/ con un umbral bajo, para que los archivos grandes se proyecten
+void test_SourceManager() {
+    SourceManager sources(4 * 1024);
+    vector<string> paths;
+    for (const auto& entry : filesystem::directory_iterator("./test/")) {
+        if (entry.path().extension() == ".hulk") paths.push_back(entry.path().string());
+    }
+    sort(paths.begin(), paths.end());
+
+    cout << "\n=== CARGA DE FUENTES ===\n";
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (i + 1 < paths.size()) sources.prefetch(paths[i + 1]);
+        const SourceFile& file = sources.load(paths[i]);
+        string_view text = file.getText();
+        uint32_t last = text.empty() ? 0 : (uint32_t)text.size() - 1;
+        cout << file.getPath() << ": " << text.size() << " bytes, " << file.numLines() << " lineas, "
+             << (file.isMapped() ? "mmap" : "buffer") << ", ultimo caracter en "
+             << file.line(last) << ":" << file.column(last) << "\n";
+        sources.release(file.getId());
+    }
+    cout << sources.numFiles() << " archivos, " << sources.numMapped() << " proyectados, "
+         << sources.numBuffers() << " buffers\n";
+}
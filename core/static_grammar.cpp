@@ -0,0 +1,502 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <initializer_list>
+#include <cstdint>
+
+//#include "parsers.cpp"
+
+using namespace std;
+
+
+/*
+ * Gramaticas estaticas
+ *      Una gramatica fija se declara en C++ como un tipo con los miembros
+ *
+ *          static constexpr int NUM_TERMINALS;     // incluye $ (el ultimo terminal)
+ *          static constexpr int NUM_SYMBOLS;       // terminales y no terminales
+ *          static constexpr int START;             // no terminal inicial
+ *          static constexpr const char* NAMES[NUM_SYMBOLS];
+ *          static constexpr StaticProduction<K> PRODUCTIONS[];
+ *
+ *      usando un enum para los simbolos con el mismo orden que los indices
+ *      densos de Grammar: terminales, $, no terminales (ver ExprSyntax).
+ *      StaticLL1<Syntax> calcula First, Follow y la tabla LL(1) durante la
+ *      compilacion; una gramatica que no es LL(1), un simbolo fuera de rango
+ *      o una produccion mas larga que K son errores de compilacion
+ */
+
+
+/**
+ * Produccion de una gramatica estatica: {izquierda, {derecha...}}
+ */
+template<int MaxRight>
+struct StaticProduction {
+    int left;
+    int size;
+    int right[MaxRight > 0 ? MaxRight : 1];
+
+    constexpr StaticProduction(int left, initializer_list<int> symbols) : left(left), size(0), right{} {
+        for (int symbol : symbols) {
+            if (size == MaxRight) throw "produccion mas larga que MaxRight";
+            right[size++] = symbol;
+        }
+    }
+};
+
+
+/**
+ * Conjunto de terminales como bitset, utilizable en expresiones constantes
+ */
+template<int N>
+struct StaticSet {
+    uint64_t words[(N + 63) / 64] = {};
+
+    constexpr bool contains(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+    constexpr bool insert(int i) {
+        uint64_t bit = uint64_t(1) << (i & 63);
+        bool added = !(words[i >> 6] & bit);
+        words[i >> 6] |= bit;
+        return added;
+    }
+
+    /**
+     * Une other a este conjunto; devuelve si cambio
+     */
+    constexpr bool merge(const StaticSet& other) {
+        bool changed = false;
+        for (int w = 0; w < (N + 63) / 64; ++w) {
+            uint64_t merged = words[w] | other.words[w];
+            changed |= merged != words[w];
+            words[w] = merged;
+        }
+        return changed;
+    }
+};
+
+/**
+ * Un conjunto de terminales por simbolo, y si el simbolo es anulable
+ * (First) o el conjunto Follow (nullable sin usar)
+ */
+template<int NumTerminals, int NumSymbols>
+struct StaticSymbolSets {
+    StaticSet<NumTerminals> sets[NumSymbols] = {};
+    bool nullable[NumSymbols] = {};
+};
+
+template<int NumTerminals, int NumNonTerminals>
+struct StaticLL1Table {
+    static constexpr int ERROR = -1;
+
+    int16_t cells[NumNonTerminals][NumTerminals] = {};
+    int conflicts = 0;
+    int conflict_nonterminal = -1;      // primer conflicto encontrado
+    int conflict_terminal = -1;
+};
+
+
+template<typename Syntax>
+constexpr int staticNumProductions() {
+    return (int)(sizeof(Syntax::PRODUCTIONS) / sizeof(Syntax::PRODUCTIONS[0]));
+}
+
+constexpr bool staticNameEquals(const char* a, const char* b) {
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+/**
+ * Comprueba la forma de la gramatica; cada error detiene la compilacion
+ */
+template<typename Syntax>
+constexpr bool staticValidate() {
+    constexpr int NT = Syntax::NUM_TERMINALS;
+    constexpr int NS = Syntax::NUM_SYMBOLS;
+    if (NT < 1 || NS <= NT) throw "NUM_TERMINALS y NUM_SYMBOLS inconsistentes";
+    if (!staticNameEquals(Syntax::NAMES[NT - 1], "$")) throw "el ultimo terminal debe llamarse $";
+    if (Syntax::START < NT || Syntax::START >= NS) throw "START no es un no terminal";
+    for (const auto& p : Syntax::PRODUCTIONS) {
+        if (p.left < NT || p.left >= NS) throw "la parte izquierda no es un no terminal";
+        for (int i = 0; i < p.size; ++i) {
+            if (p.right[i] < 0 || p.right[i] >= NS) throw "simbolo fuera de rango";
+            if (p.right[i] == NT - 1) throw "$ no puede aparecer en una produccion";
+        }
+    }
+    return true;
+}
+
+/**
+ * First de cada simbolo (punto fijo sobre las producciones)
+ */
+template<typename Syntax>
+constexpr StaticSymbolSets<Syntax::NUM_TERMINALS, Syntax::NUM_SYMBOLS> staticFirsts() {
+    StaticSymbolSets<Syntax::NUM_TERMINALS, Syntax::NUM_SYMBOLS> first;
+    for (int a = 0; a < Syntax::NUM_TERMINALS; ++a) first.sets[a].insert(a);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& p : Syntax::PRODUCTIONS) {
+            bool all_nullable = true;
+            for (int i = 0; i < p.size && all_nullable; ++i) {
+                changed |= first.sets[p.left].merge(first.sets[p.right[i]]);
+                all_nullable = first.nullable[p.right[i]];
+            }
+            if (all_nullable && !first.nullable[p.left]) {
+                first.nullable[p.left] = true;
+                changed = true;
+            }
+        }
+    }
+    return first;
+}
+
+/**
+ * Follow de cada no terminal
+ */
+template<typename Syntax>
+constexpr StaticSymbolSets<Syntax::NUM_TERMINALS, Syntax::NUM_SYMBOLS>
+staticFollows(const StaticSymbolSets<Syntax::NUM_TERMINALS, Syntax::NUM_SYMBOLS>& first) {
+    StaticSymbolSets<Syntax::NUM_TERMINALS, Syntax::NUM_SYMBOLS> follow;
+    follow.sets[Syntax::START].insert(Syntax::NUM_TERMINALS - 1);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& p : Syntax::PRODUCTIONS) {
+            for (int i = 0; i < p.size; ++i) {
+                int X = p.right[i];
+                if (X < Syntax::NUM_TERMINALS) continue;
+                bool rest_nullable = true;
+                for (int j = i + 1; j < p.size && rest_nullable; ++j) {
+                    changed |= follow.sets[X].merge(first.sets[p.right[j]]);
+                    rest_nullable = first.nullable[p.right[j]];
+                }
+                if (rest_nullable) changed |= follow.sets[X].merge(follow.sets[p.left]);
+            }
+        }
+    }
+    return follow;
+}
+
+/**
+ * Tabla LL(1): TABLE[A, a] = p si a esta en el conjunto de prediccion de p.
+ * Los conflictos se cuentan (la celda se queda con la primera produccion)
+ */
+template<typename Syntax>
+constexpr StaticLL1Table<Syntax::NUM_TERMINALS, Syntax::NUM_SYMBOLS - Syntax::NUM_TERMINALS>
+staticLL1Table(const StaticSymbolSets<Syntax::NUM_TERMINALS, Syntax::NUM_SYMBOLS>& first,
+               const StaticSymbolSets<Syntax::NUM_TERMINALS, Syntax::NUM_SYMBOLS>& follow) {
+    constexpr int NT = Syntax::NUM_TERMINALS;
+    StaticLL1Table<NT, Syntax::NUM_SYMBOLS - NT> table;
+    for (auto& row : table.cells) {
+        for (auto& cell : row) cell = table.ERROR;
+    }
+
+    for (int p = 0; p < staticNumProductions<Syntax>(); ++p) {
+        const auto& production = Syntax::PRODUCTIONS[p];
+        StaticSet<NT> prediction;
+        bool nullable = true;
+        for (int i = 0; i < production.size && nullable; ++i) {
+            prediction.merge(first.sets[production.right[i]]);
+            nullable = first.nullable[production.right[i]];
+        }
+        if (nullable) prediction.merge(follow.sets[production.left]);
+
+        for (int a = 0; a < NT; ++a) {
+            if (!prediction.contains(a)) continue;
+            int16_t& cell = table.cells[production.left - NT][a];
+            if (cell == table.ERROR) {
+                cell = (int16_t)p;
+            } else if (table.conflicts++ == 0) {
+                table.conflict_nonterminal = production.left;
+                table.conflict_terminal = a;
+            }
+        }
+    }
+    return table;
+}
+
+
+/**
+ * StaticLL1
+ *      Analisis LL(1) de una gramatica estatica, hecho por el compilador:
+ *      FIRSTS, FOLLOWS y TABLE son arreglos constexpr. Ofrece la misma
+ *      interfaz de indices densos que Grammar y la consulta de LL1Table, asi
+ *      runLL1 la usa directamente (ver StaticLL1Parser).
+ *      Los Symbol (para traducir tokens del lexer y para los mensajes de
+ *      error) se crean la primera vez que se piden
+ */
+template<typename Syntax>
+class StaticLL1 {
+public:
+    static constexpr int NUM_TERMINALS = Syntax::NUM_TERMINALS;
+    static constexpr int NUM_SYMBOLS = Syntax::NUM_SYMBOLS;
+    static constexpr int NUM_PRODUCTIONS = staticNumProductions<Syntax>();
+    static constexpr int ERROR = -1;
+
+    // La validacion va primero: un error de forma se reporta antes de analizar
+    static constexpr auto FIRSTS = (staticValidate<Syntax>(), staticFirsts<Syntax>());
+    static constexpr auto FOLLOWS = staticFollows<Syntax>(FIRSTS);
+    static constexpr auto TABLE = staticLL1Table<Syntax>(FIRSTS, FOLLOWS);
+
+    static_assert(TABLE.conflicts == 0,
+                  "La gramatica no es LL(1): ver TABLE.conflict_nonterminal y TABLE.conflict_terminal");
+
+private:
+    static const vector<Symbol>& symbols() {
+        static const vector<Symbol> all = [] {
+            vector<Symbol> result;
+            for (int i = 0; i < NUM_SYMBOLS; ++i) result.emplace_back(Syntax::NAMES[i], i < NUM_TERMINALS);
+            return result;
+        }();
+        return all;
+    }
+
+    static const vector<int>& indexById() {
+        static const vector<int> index = [] {
+            vector<int> result;
+            for (int i = 0; i < NUM_SYMBOLS; ++i) {
+                int id = symbols()[i].getId();
+                if (id >= (int)result.size()) result.resize(id + 1, -1);
+                result[id] = i;
+            }
+            return result;
+        }();
+        return index;
+    }
+
+public:
+    // Indices densos (misma interfaz que Grammar)
+    static const Symbol& symbolAt(int index) { return symbols()[index]; }
+    static int indexOfId(int id) {
+        const vector<int>& index = indexById();
+        return (id >= 0 && id < (int)index.size()) ? index[id] : -1;
+    }
+    static constexpr int numSymbols() { return NUM_SYMBOLS; }
+    static constexpr int numTerminals() { return NUM_TERMINALS; }
+    static constexpr bool isTerminalIndex(int index) { return index < NUM_TERMINALS; }
+    static constexpr int eofIndex() { return NUM_TERMINALS - 1; }
+    static constexpr int startIndex() { return Syntax::START; }
+
+    static constexpr int numProductions() { return NUM_PRODUCTIONS; }
+    static constexpr int leftIndex(int p) { return Syntax::PRODUCTIONS[p].left; }
+    static constexpr const int* rightBegin(int p) { return Syntax::PRODUCTIONS[p].right; }
+    static constexpr const int* rightEnd(int p) {
+        return Syntax::PRODUCTIONS[p].right + Syntax::PRODUCTIONS[p].size;
+    }
+    static constexpr int rightSize(int p) { return Syntax::PRODUCTIONS[p].size; }
+
+    static constexpr int get(int A, int a) { return TABLE.cells[A - NUM_TERMINALS][a]; }
+
+    static string productionToString(int p) {
+        string text = string(Syntax::NAMES[leftIndex(p)]) + " ->";
+        if (rightSize(p) == 0) text += " " + EPSILON;
+        for (const int* it = rightBegin(p); it != rightEnd(p); ++it) {
+            text += " " + string(Syntax::NAMES[*it]);
+        }
+        return text;
+    }
+
+    /**
+     * Grammar equivalente (para comparar con el analisis en tiempo de ejecucion)
+     */
+    static Grammar toGrammar() {
+        unordered_set<Symbol> terminals, nonterminals;
+        for (int i = 0; i < NUM_SYMBOLS; ++i) {
+            if (i == eofIndex()) continue;
+            (i < NUM_TERMINALS ? terminals : nonterminals).insert(symbolAt(i));
+        }
+        vector<Production> productions;
+        for (int p = 0; p < NUM_PRODUCTIONS; ++p) {
+            vector<Symbol> right;
+            for (const int* it = rightBegin(p); it != rightEnd(p); ++it) right.push_back(symbolAt(*it));
+            productions.push_back(Production(symbolAt(leftIndex(p)), Sentence(right)));
+        }
+        return Grammar(terminals, nonterminals, symbolAt(startIndex()), productions);
+    }
+};
+
+
+/**
+ * Entrada: indices densos de terminales (los valores del enum de la gramatica)
+ */
+template<typename Symbols>
+struct IndexInput {
+    const Symbols& G;
+    const vector<int>& input;
+    size_t cursor;
+    int current;
+
+    IndexInput(const Symbols& G, const vector<int>& input) : G(G), input(input), cursor(0), current(at(0)) {}
+    int at(size_t i) const {
+        if (i >= input.size()) return NO_INPUT;
+        return input[i] >= 0 && G.isTerminalIndex(input[i]) ? input[i] : -1;
+    }
+    void advance() { current = at(++cursor); }
+    Token token() const { return {input[cursor], (uint32_t)cursor, 0, 0}; }
+    string describe() const {
+        int index = input[cursor];
+        return index >= 0 && index < G.numSymbols() ? G.symbolAt(index).getName() : to_string(index);
+    }
+};
+
+
+/**
+ * StaticLL1Parser
+ *      Parser LL(1) sobre la tabla calculada en compilacion: no hay
+ *      construccion ni validacion de la gramatica al arrancar
+ */
+template<typename Syntax>
+class StaticLL1Parser {
+public:
+    using Analysis = StaticLL1<Syntax>;
+
+private:
+    Analysis analysis;
+
+public:
+    template<typename Listener>
+    void parse(const vector<int>& input, Listener& listener) const {
+        IndexInput in(analysis, input);
+        runLL1(analysis, analysis, in, listener);
+    }
+
+    template<typename Listener>
+    void parse(const vector<Symbol>& input, Listener& listener) const {
+        SymbolInput in(analysis, input);
+        runLL1(analysis, analysis, in, listener);
+    }
+
+    template<typename Listener>
+    void parse(const TokenStream& tokens, Listener& listener) const {
+        StreamInput in(analysis, tokens);
+        runLL1(analysis, analysis, in, listener);
+    }
+
+    template<typename Listener>
+    void parse(LexerCursor& cursor, Listener& listener) const {
+        CursorInput in(analysis, cursor);
+        runLL1(analysis, analysis, in, listener);
+    }
+
+    /**
+     * Indices de las producciones de la derivacion por la izquierda
+     */
+    vector<int> derivation(const vector<int>& input) const {
+        struct Collector : ParseListener {
+            vector<int> productions;
+            void onProduction(int p) override { productions.push_back(p); }
+        } collector;
+        parse(input, collector);
+        return collector.productions;
+    }
+
+    void printParsingTable() const {
+        cout << "\n=== TABLA LL(1) (calculada en compilacion) ===\n";
+        cout << setw(12) << "TABLE[A,a]";
+        for (int a = 0; a < Analysis::NUM_TERMINALS; ++a) cout << setw(8) << Syntax::NAMES[a];
+        cout << "\n";
+        for (int A = Analysis::NUM_TERMINALS; A < Analysis::NUM_SYMBOLS; ++A) {
+            cout << setw(12) << Syntax::NAMES[A];
+            for (int a = 0; a < Analysis::NUM_TERMINALS; ++a) {
+                int p = Analysis::get(A, a);
+                cout << setw(8) << (p == Analysis::ERROR ? string("-") : to_string(p));
+            }
+            cout << "\n";
+        }
+    }
+};
+
+
+
+
+
+
+
+
+// TEST
+// Gramatica de expresiones declarada en compilacion
+struct ExprSyntax {
+    enum : int { PLUS, MINUS, STAR, DIV, OPAR, CPAR, NUM, END, E, X, T, Y, F, COUNT };
+
+    static constexpr int NUM_TERMINALS = END + 1;
+    static constexpr int NUM_SYMBOLS = COUNT;
+    static constexpr int START = E;
+    static constexpr const char* NAMES[NUM_SYMBOLS] = {
+        "+", "-", "*", "/", "(", ")", "num", "$", "E", "X", "T", "Y", "F"};
+
+    static constexpr StaticProduction<3> PRODUCTIONS[] = {
+        {E, {T, X}},
+        {X, {PLUS, T, X}},
+        {X, {MINUS, T, X}},
+        {X, {}},
+        {T, {F, Y}},
+        {Y, {STAR, F, Y}},
+        {Y, {DIV, F, Y}},
+        {Y, {}},
+        {F, {NUM}},
+        {F, {OPAR, E, CPAR}},
+    };
+};
+
+// Con {F, {E}} agregada la compilacion falla: "La gramatica no es LL(1)"
+static_assert(StaticLL1<ExprSyntax>::get(ExprSyntax::F, ExprSyntax::NUM) == 8,
+              "TABLE[F, num] se calcula en compilacion");
+
+/**
+ * Compara FIRSTS, FOLLOWS y TABLE con ParsingTable sobre toGrammar(), celda
+ * por celda (los indices se traducen por nombre de simbolo)
+ * @return Cantidad de diferencias
+ */
+template<typename Syntax>
+int compareWithParsingTable() {
+    using Static = StaticLL1<Syntax>;
+    Grammar G = Static::toGrammar();
+    ParsingTable runtime(G);
+    int differences = 0;
+    auto differ = [&](const string& what) {
+        cout << "  difiere " << what << "\n";
+        ++differences;
+    };
+
+    for (int X = 0; X < Static::NUM_SYMBOLS; ++X) {
+        int x = G.indexOf(Static::symbolAt(X));
+        string name = Syntax::NAMES[X];
+        const ContainerSet& first = runtime.getFirsts()[x];
+        if (Static::FIRSTS.nullable[X] != first.containsEpsilon()) differ("First(" + name + ") epsilon");
+        for (int a = 0; a < Static::NUM_TERMINALS; ++a) {
+            int t = G.indexOf(Static::symbolAt(a));
+            string cell = name + ", " + Syntax::NAMES[a];
+            if (Static::FIRSTS.sets[X].contains(a) != first.contains(t)) differ("First(" + cell + ")");
+            if (Static::isTerminalIndex(X)) continue;
+            if (Static::FOLLOWS.sets[X].contains(a) != runtime.getFollows()[x].contains(t)) {
+                differ("Follow(" + cell + ")");
+            }
+            if (Static::get(X, a) != runtime.getTable().get(x, t)) differ("TABLE[" + cell + "]");
+        }
+    }
+    return differences;
+}
+
+void test_StaticLL1() {
+    using S = ExprSyntax;
+    StaticLL1Parser<S> parser;
+    parser.printParsingTable();
+
+    cout << "\nComparacion con ParsingTable(toGrammar()):\n";
+    int differences = compareWithParsingTable<S>();
+    cout << "  " << (differences == 0 ? "First, Follow y la tabla coinciden" :
+                     to_string(differences) + " diferencias") << "\n";
+
+    vector<int> input = {S::NUM, S::PLUS, S::OPAR, S::NUM, S::STAR, S::NUM, S::CPAR, S::END};
+    cout << "\nDerivacion de num + ( num * num ):\n";
+    for (int p : parser.derivation(input)) {
+        cout << "  " << StaticLL1<S>::productionToString(p) << "\n";
+    }
+}
@@ -0,0 +1,618 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <filesystem>
+#include <string>
+#include <stdexcept>
+#include <memory>
+#include <unordered_map>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define HULK_TABLE_FILE_MMAP 1
+#endif
+
+//#include "parsers.cpp"
+
+using namespace std;
+
+
+/*
+ * Archivo binario de tablas de parsing
+ *
+ *      [TableFileHeader][seccion][seccion]...
+ *
+ *      Todo es little/big endian nativo (byte_order permite detectar un archivo
+ *      de otra arquitectura) y todas las posiciones son desplazamientos desde
+ *      el inicio del archivo, asi que el archivo se usa tal cual desde un mmap
+ *      en cualquier direccion. Cada seccion empieza alineada a 8 bytes.
+ *
+ *      Secciones:
+ *          NAME_OFFSETS    n_symbols + 1 desplazamientos dentro de NAME_POOL
+ *          NAME_POOL       nombres de los simbolos concatenados (por indice denso)
+ *          PROD_LEFT       no terminal de cada produccion
+ *          RHS_OFFSET      n_productions + 1 comienzos en RHS
+ *          RHS             partes derechas aplanadas
+ *          T0_* / T1_*     arreglos de PackedTable (base, defaults, next, check)
+ *
+ *      LL(1): T0 es la tabla de prediccion (fila = no terminal - n_terminals).
+ *      LR: T0 es ACTION (fila = estado) y T1 es GOTO por columnas
+ *      (fila = no terminal - n_terminals, columna = estado).
+ *
+ *      checksum es FNV-1a de 64 bits de todo el archivo salvo el propio campo
+ */
+enum TableFileSectionId {
+    NAME_OFFSETS, NAME_POOL, PROD_LEFT, RHS_OFFSET, RHS,
+    T0_BASE, T0_DEFAULTS, T0_NEXT, T0_CHECK,
+    T1_BASE, T1_DEFAULTS, T1_NEXT, T1_CHECK,
+    NUM_TABLE_FILE_SECTIONS
+};
+
+struct TableFileSection {
+    uint64_t offset;
+    uint64_t size;          // en bytes
+};
+
+struct TableFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t kind;
+    uint32_t header_size;
+    uint64_t file_size;
+    uint64_t checksum;
+    int32_t n_symbols;
+    int32_t n_terminals;
+    int32_t n_productions;
+    int32_t n_positions;
+    int32_t start_index;
+    int32_t n_states;
+    int32_t rows[2];
+    int32_t cols[2];
+    TableFileSection sections[NUM_TABLE_FILE_SECTIONS];
+};
+
+static const char TABLE_FILE_MAGIC[8] = {'H', 'U', 'L', 'K', 'T', 'B', 'L', '\0'};
+constexpr uint32_t TABLE_FILE_VERSION = 1;
+constexpr uint32_t TABLE_FILE_BYTE_ORDER = 0x01020304;
+constexpr uint32_t TABLE_FILE_LL1 = 1;
+constexpr uint32_t TABLE_FILE_LR = 2;
+
+
+/**
+ * FNV-1a de 64 bits del archivo completo, tomando el campo checksum como ceros
+ */
+uint64_t tableFileChecksum(const unsigned char* data, size_t size) {
+    const size_t skip_begin = offsetof(TableFileHeader, checksum);
+    const size_t skip_end = skip_begin + sizeof(uint64_t);
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char byte = (i >= skip_begin && i < skip_end) ? 0 : data[i];
+        hash = (hash ^ byte) * 1099511628211ull;
+    }
+    return hash;
+}
+
+
+/**
+ * PackedTableView
+ *      PackedTable de solo lectura sobre arreglos que no le pertenecen
+ *      (las secciones de un TableFile); misma consulta O(1)
+ */
+struct PackedTableView {
+    const int32_t* base = nullptr;
+    const int32_t* defaults = nullptr;
+    const int32_t* next = nullptr;
+    const int32_t* check = nullptr;
+
+    int32_t get(int row, int col) const {
+        size_t i = (size_t)base[row] + col;
+        return check[i] == col ? next[i] : defaults[row];
+    }
+};
+
+
+/**
+ * Escritura del archivo: las secciones se acumulan en memoria y el
+ * encabezado (con el checksum) se completa al final
+ */
+class TableFileWriter {
+private:
+    vector<unsigned char> bytes;
+    TableFileHeader header;
+
+    void align() {
+        bytes.resize((bytes.size() + 7) & ~(size_t)7, 0);
+    }
+
+    void section(TableFileSectionId id, const void* data, size_t size) {
+        align();
+        header.sections[id] = {bytes.size(), size};
+        const unsigned char* begin = (const unsigned char*)data;
+        bytes.insert(bytes.end(), begin, begin + size);
+    }
+
+    void section(TableFileSectionId id, const vector<int32_t>& values) {
+        section(id, values.data(), values.size() * sizeof(int32_t));
+    }
+
+    /**
+     * Empaqueta una tabla dada por celdas: el defecto de cada fila es su
+     * valor mas frecuente, asi get() devuelve exactamente lo mismo que cell()
+     */
+    template<typename Cell>
+    void pack(int t, int n_rows, int n_cols, Cell cell) {
+        vector<int32_t> cells((size_t)n_rows * n_cols);
+        vector<int32_t> defaults(n_rows);
+        unordered_map<int32_t, int> count;
+        for (int r = 0; r < n_rows; ++r) {
+            count.clear();
+            int32_t best = 0;
+            int best_count = 0;
+            for (int c = 0; c < n_cols; ++c) {
+                int32_t value = cell(r, c);
+                cells[(size_t)r * n_cols + c] = value;
+                int n = ++count[value];
+                if (n > best_count) {
+                    best = value;
+                    best_count = n;
+                }
+            }
+            defaults[r] = best;
+        }
+        PackedTable packed(cells, n_rows, n_cols, defaults);
+        header.rows[t] = n_rows;
+        header.cols[t] = n_cols;
+        int first = t == 0 ? T0_BASE : T1_BASE;
+        section(TableFileSectionId(first), packed.getBase());
+        section(TableFileSectionId(first + 1), packed.getDefaults());
+        section(TableFileSectionId(first + 2), packed.getNext());
+        section(TableFileSectionId(first + 3), packed.getCheck());
+    }
+
+public:
+    TableFileWriter(const Grammar& G, uint32_t kind) : bytes(sizeof(TableFileHeader), 0) {
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TABLE_FILE_MAGIC, sizeof(header.magic));
+        header.version = TABLE_FILE_VERSION;
+        header.byte_order = TABLE_FILE_BYTE_ORDER;
+        header.kind = kind;
+        header.header_size = sizeof(TableFileHeader);
+        header.n_symbols = G.numSymbols();
+        header.n_terminals = G.numTerminals();
+        header.n_productions = G.numProductions();
+        header.n_positions = G.numPositions();
+        header.start_index = G.startIndex();
+
+        vector<int32_t> name_offsets;
+        string pool;
+        for (int i = 0; i < G.numSymbols(); ++i) {
+            name_offsets.push_back((int32_t)pool.size());
+            pool += G.symbolAt(i).getName();
+        }
+        name_offsets.push_back((int32_t)pool.size());
+        section(NAME_OFFSETS, name_offsets);
+        section(NAME_POOL, pool.data(), pool.size());
+
+        vector<int32_t> prod_left, rhs_offset;
+        for (int p = 0; p < G.numProductions(); ++p) {
+            prod_left.push_back(G.leftIndex(p));
+            rhs_offset.push_back(G.rightOffset(p));
+        }
+        rhs_offset.push_back(G.numPositions());
+        section(PROD_LEFT, prod_left);
+        section(RHS_OFFSET, rhs_offset);
+        section(RHS, G.numProductions() ? G.rightBegin(0) : nullptr, G.numPositions() * sizeof(int32_t));
+    }
+
+    void save(const ParsingTable& table) {
+        const Grammar& G = table.getGrammar();
+        const LL1Table& TABLE = table.getTable();
+        int n_terminals = G.numTerminals();
+        pack(0, G.numNonTerminals(), n_terminals,
+             [&](int r, int c) { return (int32_t)TABLE.get(r + n_terminals, c); });
+    }
+
+    void save(const LRTable& table) {
+        const Grammar& G = table.getGrammar();
+        int n_terminals = G.numTerminals();
+        header.n_states = table.numStates();
+        pack(0, table.numStates(), n_terminals,
+             [&](int r, int c) { return table.action(r, c); });
+        pack(1, G.numNonTerminals(), table.numStates(),
+             [&](int r, int c) { return table.gotoState(c, r + n_terminals); });
+    }
+
+    void write(const string& path) {
+        align();
+        header.file_size = bytes.size();
+        memcpy(bytes.data(), &header, sizeof(header));
+        header.checksum = tableFileChecksum(bytes.data(), bytes.size());
+        memcpy(bytes.data(), &header, sizeof(header));
+
+        ofstream out(path, ios::binary | ios::trunc);
+        if (!out) throw runtime_error("No se pudo crear el archivo de tablas " + path);
+        out.write((const char*)bytes.data(), (streamsize)bytes.size());
+        if (!out) throw runtime_error("No se pudo escribir el archivo de tablas " + path);
+    }
+};
+
+
+/**
+ * Guarda la gramatica y la tabla LL(1) en un archivo binario (ver TableFile)
+ */
+void saveParseTables(const ParsingTable& table, const string& path) {
+    if (!table.isLL1()) {
+        throw runtime_error("La gramatica no es LL(1):\n" + table.conflictReport());
+    }
+    TableFileWriter writer(table.getGrammar(), TABLE_FILE_LL1);
+    writer.save(table);
+    writer.write(path);
+}
+
+/**
+ * Guarda la gramatica y las tablas ACTION/GOTO en un archivo binario (ver TableFile)
+ */
+void saveParseTables(const LRTable& table, const string& path) {
+    if (table.hasConflicts()) {
+        throw runtime_error("La gramatica no es " + table.getKind() + ":\n" + table.conflictReport());
+    }
+    TableFileWriter writer(table.getGrammar(), TABLE_FILE_LR);
+    writer.save(table);
+    writer.write(path);
+}
+
+
+/**
+ * TableFile
+ *      Tablas de parsing cargadas de un archivo de saveParseTables. El archivo
+ *      se proyecta con mmap y las consultas leen directamente de el; al
+ *      cargar se validan el encabezado, las secciones y la gramatica y se
+ *      internan los nombres de los simbolos (para traducir ids de token a
+ *      indices densos). El checksum y el rango de las celdas de las tablas
+ *      solo se comprueban con verify. Donde no hay mmap el archivo se lee a
+ *      un buffer.
+ *
+ *      Expone la misma interfaz de indices densos que Grammar y las consultas
+ *      de LL1Table / LRTable, asi runLL1 y runLR funcionan sobre ella sin copias
+ */
+class TableFile {
+public:
+    static constexpr int ERROR = LL1Table::ERROR;
+
+private:
+    const unsigned char* data;
+    size_t size;
+    void* mapping;
+    vector<uint64_t> buffer;        // solo sin mmap (uint64_t para la alineacion)
+    TableFileHeader header;
+
+    const int32_t* name_offsets;
+    const char* name_pool;
+    const int32_t* prod_left;
+    const int32_t* rhs_offset;
+    const int32_t* rhs;
+    PackedTableView tables[2];
+
+    vector<Symbol> symbols;
+    vector<int> index_of;           // id de SymbolTable -> indice denso (-1 si no esta)
+
+    [[noreturn]] void invalid(const string& path, const string& message) {
+        release();
+        throw runtime_error("Archivo de tablas invalido " + path + ": " + message);
+    }
+
+    void release() {
+#ifdef HULK_TABLE_FILE_MMAP
+        if (mapping) munmap(mapping, size);
+#endif
+        mapping = nullptr;
+        data = nullptr;
+    }
+
+    void load(const string& path) {
+#ifdef HULK_TABLE_FILE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("No se pudo abrir el archivo de tablas " + path);
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw runtime_error("No se pudo abrir el archivo de tablas " + path);
+        }
+        size = (size_t)info.st_size;
+        if (size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                mapping = p;
+                data = (const unsigned char*)p;
+            }
+        }
+        ::close(fd);
+        if (mapping) return;
+#endif
+        ifstream in(path, ios::binary | ios::ate);
+        if (!in) throw runtime_error("No se pudo abrir el archivo de tablas " + path);
+        size = (size_t)in.tellg();
+        buffer.assign((size + 7) / 8, 0);
+        in.seekg(0);
+        in.read((char*)buffer.data(), (streamsize)size);
+        if (!in) throw runtime_error("No se pudo leer el archivo de tablas " + path);
+        data = (const unsigned char*)buffer.data();
+    }
+
+    const void* sectionData(const string& path, TableFileSectionId id, uint64_t expected) {
+        const TableFileSection& s = header.sections[id];
+        if (s.offset % 8 != 0 || s.offset < sizeof(TableFileHeader) ||
+            s.offset > size || s.size > size - s.offset || s.size != expected) {
+            invalid(path, "seccion " + to_string(id) + " fuera de rango");
+        }
+        return data + s.offset;
+    }
+
+    void mapTable(const string& path, int t) {
+        int rows = header.rows[t];
+        int cols = header.cols[t];
+        if (rows < 0 || cols < 0) invalid(path, "dimensiones de tabla negativas");
+        int first = t == 0 ? T0_BASE : T1_BASE;
+        uint64_t slots = header.sections[first + 2].size / sizeof(int32_t);
+        PackedTableView& view = tables[t];
+        view.base = (const int32_t*)sectionData(path, TableFileSectionId(first), (uint64_t)rows * 4);
+        view.defaults = (const int32_t*)sectionData(path, TableFileSectionId(first + 1), (uint64_t)rows * 4);
+        view.next = (const int32_t*)sectionData(path, TableFileSectionId(first + 2), slots * 4);
+        view.check = (const int32_t*)sectionData(path, TableFileSectionId(first + 3), slots * 4);
+        for (int r = 0; r < rows; ++r) {
+            if (view.base[r] < 0 || (uint64_t)view.base[r] + cols > slots) {
+                invalid(path, "desplazamiento de fila fuera de rango");
+            }
+        }
+    }
+
+    /**
+     * Comprueba que toda celda que puede devolver la tabla t (defectos y
+     * entradas con check valido) cumpla valid: los parsers usan esos valores
+     * como indices de produccion y de estado sin volver a revisarlos
+     */
+    template<typename Valid>
+    void checkCells(const string& path, int t, const char* what, const Valid& valid) {
+        const PackedTableView& view = tables[t];
+        int cols = header.cols[t];
+        uint64_t slots = header.sections[(t == 0 ? T0_BASE : T1_BASE) + 2].size / sizeof(int32_t);
+        for (int r = 0; r < header.rows[t]; ++r) {
+            if (!valid(view.defaults[r])) invalid(path, string("celda de ") + what + " fuera de rango");
+        }
+        for (uint64_t i = 0; i < slots; ++i) {
+            if (view.check[i] >= 0 && view.check[i] < cols && !valid(view.next[i])) {
+                invalid(path, string("celda de ") + what + " fuera de rango");
+            }
+        }
+    }
+
+public:
+    /**
+     * @param verify Si se comprueban el checksum y el rango de las celdas
+     *        (recorre el archivo completo). Sin verify las celdas se usan tal
+     *        cual: solo para archivos de saveParseTables en los que se confia
+     */
+    TableFile(const string& path, bool verify = true) : data(nullptr), size(0), mapping(nullptr) {
+        load(path);
+        if (size < sizeof(TableFileHeader)) invalid(path, "archivo demasiado corto");
+        memcpy(&header, data, sizeof(header));
+        if (memcmp(header.magic, TABLE_FILE_MAGIC, sizeof(header.magic)) != 0) {
+            invalid(path, "no es un archivo de tablas");
+        }
+        if (header.byte_order != TABLE_FILE_BYTE_ORDER) invalid(path, "orden de bytes distinto");
+        if (header.version != TABLE_FILE_VERSION) {
+            invalid(path, "version " + to_string(header.version) + ", se esperaba " +
+                          to_string(TABLE_FILE_VERSION));
+        }
+        if (header.header_size != sizeof(TableFileHeader) || header.file_size != size) {
+            invalid(path, "tamano incorrecto (archivo truncado?)");
+        }
+        if (header.kind != TABLE_FILE_LL1 && header.kind != TABLE_FILE_LR) {
+            invalid(path, "tipo de tabla desconocido");
+        }
+        if (verify && tableFileChecksum(data, size) != header.checksum) {
+            invalid(path, "checksum incorrecto");
+        }
+
+        int n_symbols = header.n_symbols;
+        int n_terminals = header.n_terminals;
+        int n_productions = header.n_productions;
+        if (n_terminals < 1 || n_symbols < n_terminals || n_productions < 0 || header.n_positions < 0 ||
+            header.start_index < n_terminals || header.start_index >= n_symbols) {
+            invalid(path, "contadores de la gramatica inconsistentes");
+        }
+        name_offsets = (const int32_t*)sectionData(path, NAME_OFFSETS, (uint64_t)(n_symbols + 1) * 4);
+        name_pool = (const char*)sectionData(path, NAME_POOL, (uint64_t)name_offsets[n_symbols]);
+        prod_left = (const int32_t*)sectionData(path, PROD_LEFT, (uint64_t)n_productions * 4);
+        rhs_offset = (const int32_t*)sectionData(path, RHS_OFFSET, (uint64_t)(n_productions + 1) * 4);
+        rhs = (const int32_t*)sectionData(path, RHS, (uint64_t)header.n_positions * 4);
+
+        for (int i = 0; i < n_symbols; ++i) {
+            if (name_offsets[i] < 0 || name_offsets[i] > name_offsets[i + 1]) {
+                invalid(path, "tabla de nombres corrupta");
+            }
+        }
+        for (int p = 0; p < n_productions; ++p) {
+            if (prod_left[p] < n_terminals || prod_left[p] >= n_symbols ||
+                rhs_offset[p] < 0 || rhs_offset[p] > rhs_offset[p + 1]) {
+                invalid(path, "producciones corruptas");
+            }
+        }
+        if (rhs_offset[n_productions] != header.n_positions) invalid(path, "producciones corruptas");
+        for (int i = 0; i < header.n_positions; ++i) {
+            if (rhs[i] < 0 || rhs[i] >= n_symbols) invalid(path, "producciones corruptas");
+        }
+
+        if (header.kind == TABLE_FILE_LL1) {
+            if (header.rows[0] != n_symbols - n_terminals || header.cols[0] != n_terminals) {
+                invalid(path, "dimensiones de la tabla LL(1) incorrectas");
+            }
+            mapTable(path, 0);
+            if (verify) {
+                checkCells(path, 0, "la tabla LL(1)", [&](int32_t p) { return p >= ERROR && p < n_productions; });
+            }
+        } else {
+            if (header.n_states < 1 || header.rows[0] != header.n_states || header.cols[0] != n_terminals ||
+                header.rows[1] != n_symbols - n_terminals || header.cols[1] != header.n_states) {
+                invalid(path, "dimensiones de las tablas LR incorrectas");
+            }
+            mapTable(path, 0);
+            mapTable(path, 1);
+            const int32_t n_states = header.n_states;
+            if (verify) {
+                checkCells(path, 0, "ACTION", [&](int32_t action) {
+                    if (action == LRTable::ERROR || action == LRTable::ACCEPT) return true;
+                    if (action > 0) return LRTable::shiftTarget(action) < n_states;
+                    return action >= -n_productions;        // reduce(p) = -(p + 1)
+                });
+                checkCells(path, 1, "GOTO", [&](int32_t state) {
+                    return state == LR0Automaton::NONE || (state >= 0 && state < n_states);
+                });
+            }
+        }
+
+        // Los nombres se internan para que los tokens del lexer (ids de
+        // SymbolTable) se traduzcan a indices; sin verify, las celdas de las
+        // tablas no se recorren al cargar
+        symbols.reserve(n_symbols);
+        for (int i = 0; i < n_symbols; ++i) {
+            string name(name_pool + name_offsets[i], name_pool + name_offsets[i + 1]);
+            symbols.emplace_back(name, i < n_terminals);
+            int id = symbols.back().getId();
+            if (id >= (int)index_of.size()) index_of.resize(id + 1, -1);
+            index_of[id] = i;
+        }
+    }
+
+    ~TableFile() { release(); }
+
+    TableFile(const TableFile&) = delete;
+    TableFile& operator=(const TableFile&) = delete;
+
+    bool isLL1() const { return header.kind == TABLE_FILE_LL1; }
+    bool isLR() const { return header.kind == TABLE_FILE_LR; }
+    bool isMapped() const { return mapping != nullptr; }
+    size_t fileSize() const { return size; }
+    int numStates() const { return header.n_states; }
+
+    // Indices densos (misma interfaz que Grammar)
+    int indexOf(const Symbol& s) const { return indexOfId(s.getId()); }
+    int indexOfId(int id) const {
+        return (id >= 0 && id < (int)index_of.size()) ? index_of[id] : -1;
+    }
+    const Symbol& symbolAt(int index) const { return symbols[index]; }
+    int numSymbols() const { return header.n_symbols; }
+    int numTerminals() const { return header.n_terminals; }
+    int numNonTerminals() const { return header.n_symbols - header.n_terminals; }
+    bool isTerminalIndex(int index) const { return index < header.n_terminals; }
+    int eofIndex() const { return header.n_terminals - 1; }
+    int startIndex() const { return header.start_index; }
+
+    int numProductions() const { return header.n_productions; }
+    int leftIndex(int p) const { return prod_left[p]; }
+    const int* rightBegin(int p) const { return rhs + rhs_offset[p]; }
+    const int* rightEnd(int p) const { return rhs + rhs_offset[p + 1]; }
+    int rightSize(int p) const { return rhs_offset[p + 1] - rhs_offset[p]; }
+
+    string productionToString(int p) const {
+        string text = symbolAt(leftIndex(p)).getName() + " ->";
+        if (rightSize(p) == 0) text += " " + EPSILON;
+        for (const int* it = rightBegin(p); it != rightEnd(p); ++it) {
+            text += " " + symbolAt(*it).getName();
+        }
+        return text;
+    }
+
+    // Consultas de las tablas, leidas del archivo
+    int get(int A, int a) const { return tables[0].get(A - header.n_terminals, a); }
+    int32_t action(int state, int a) const { return tables[0].get(state, a); }
+    int32_t gotoState(int state, int A) const { return tables[1].get(A - header.n_terminals, state); }
+};
+
+
+/**
+ * TableFileParser
+ *      Parser sobre un TableFile: segun el tipo del archivo usa el ciclo
+ *      LL(1) (eventos onProduction) o el LR (eventos onReduce)
+ */
+class TableFileParser {
+private:
+    shared_ptr<const TableFile> tables;
+
+    template<typename Input>
+    void run(Input& input, ParseListener& listener) const {
+        if (tables->isLL1()) {
+            runLL1(*tables, *tables, input, listener);
+        } else {
+            runLR(*tables, *tables, input, listener);
+        }
+    }
+
+public:
+    TableFileParser(shared_ptr<const TableFile> tables) : tables(move(tables)) {}
+    TableFileParser(const string& path) : tables(make_shared<const TableFile>(path)) {}
+
+    const TableFile& getTables() const { return *tables; }
+
+    void parse(const vector<Symbol>& input, ParseListener& listener) const {
+        SymbolInput in(*tables, input);
+        run(in, listener);
+    }
+
+    void parse(const TokenStream& tokens, ParseListener& listener) const {
+        StreamInput in(*tables, tokens);
+        run(in, listener);
+    }
+
+    void parse(LexerCursor& cursor, ParseListener& listener) const {
+        CursorInput in(*tables, cursor);
+        run(in, listener);
+    }
+};
+
+
+
+
+
+
+
+
+// TEST
+// TableFile
+void test_TableFile() {
+    HulkSyntax syntax = hulkSyntax();
+    Lexer lexer(hulkLexerRules());
+    string program = "let x = 3 in while (x > 0) x := x - 1;";
+
+    // Archivos temporales, se borran al final
+    string directory = filesystem::temp_directory_path().string();
+    string ll1_path = directory + "/hulk_ll1.tbl";
+    string lalr_path = directory + "/hulk_lalr.tbl";
+    saveParseTables(ParsingTable(syntax.grammar), ll1_path);
+    saveParseTables(*LALR1Parser::buildTable(syntax.grammar, true), lalr_path);
+
+    for (const string& path : {ll1_path, lalr_path}) {
+        auto tables = make_shared<const TableFile>(path);
+        cout << "\n=== TABLAS " << path << " ===\n";
+        cout << tables->fileSize() << " bytes, " << (tables->isMapped() ? "mmap" : "buffer") << ", "
+             << tables->numSymbols() << " simbolos, " << tables->numProductions() << " producciones\n";
+
+        Ast ast;
+        ast.reset(program);
+        HulkAstBuilder builder(syntax.grammar, syntax.actions, ast);
+        ReductionOrder bottom_up(syntax.grammar, builder);
+        LexerCursor cursor(lexer, program);
+        TableFileParser parser(tables);
+        if (tables->isLL1()) parser.parse(cursor, bottom_up);
+        else parser.parse(cursor, builder);
+        ast.print();
+    }
+    filesystem::remove(ll1_path);
+    filesystem::remove(lalr_path);
+}
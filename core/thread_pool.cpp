@@ -0,0 +1,160 @@
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <exception>
+#include <algorithm>
+
+using namespace std;
+
+
+/**
+ * ThreadPool
+ *      Pool de hilos con robo de trabajo: cada hilo tiene su propia cola,
+ *      toma tareas del final de la suya y, si esta vacia, roba del principio
+ *      de las de los demas. Las tareas enviadas desde un hilo del pool van a
+ *      su cola; las de afuera se reparten en ronda.
+ *
+ *      Cada tarea recibe el indice del hilo que la ejecuta, para que use
+ *      memoria propia de ese hilo (ver BatchCompiler) sin sincronizar.
+ *      wait() espera a que terminen todas y relanza la primera excepcion
+ */
+class ThreadPool {
+public:
+    using Task = function<void(int worker)>;
+
+private:
+    struct Worker {
+        mutex lock;
+        deque<Task> tasks;
+    };
+
+    vector<unique_ptr<Worker>> workers;
+    vector<thread> threads;
+
+    mutex state_lock;
+    condition_variable wake;            // hay tareas o hay que terminar
+    condition_variable finished;        // pending llego a 0
+    atomic<size_t> queued{0};           // tareas en alguna cola
+    atomic<size_t> pending{0};          // tareas enviadas y no terminadas
+    size_t next_queue = 0;
+    bool stopping = false;
+    exception_ptr first_error;
+
+    static int& currentWorker() {
+        static thread_local int worker = -1;
+        return worker;
+    }
+
+    static const ThreadPool*& currentPool() {
+        static thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    bool pop(int w, Task& task) {
+        Worker& worker = *workers[w];
+        lock_guard<mutex> guard(worker.lock);
+        if (worker.tasks.empty()) return false;
+        task = move(worker.tasks.back());
+        worker.tasks.pop_back();
+        --queued;
+        return true;
+    }
+
+    bool steal(int w, Task& task) {
+        const int n = (int)workers.size();
+        for (int k = 1; k < n; ++k) {
+            Worker& victim = *workers[(w + k) % n];
+            lock_guard<mutex> guard(victim.lock);
+            if (victim.tasks.empty()) continue;
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --queued;
+            return true;
+        }
+        return false;
+    }
+
+    void loop(int w) {
+        currentWorker() = w;
+        currentPool() = this;
+        Task task;
+        while (true) {
+            if (pop(w, task) || steal(w, task)) {
+                try {
+                    task(w);
+                } catch (...) {
+                    lock_guard<mutex> guard(state_lock);
+                    if (!first_error) first_error = current_exception();
+                }
+                task = nullptr;
+                if (--pending == 0) {
+                    lock_guard<mutex> guard(state_lock);
+                    finished.notify_all();
+                }
+                continue;
+            }
+
+            unique_lock<mutex> guard(state_lock);
+            wake.wait(guard, [&] { return stopping || queued > 0; });
+            if (stopping && queued == 0) return;
+        }
+    }
+
+public:
+    /**
+     * @param n_threads Cantidad de hilos (0 = uno por nucleo)
+     */
+    explicit ThreadPool(int n_threads = 0) {
+        if (n_threads <= 0) n_threads = max(1u, thread::hardware_concurrency());
+        for (int w = 0; w < n_threads; ++w) workers.push_back(make_unique<Worker>());
+        for (int w = 0; w < n_threads; ++w) threads.emplace_back([this, w] { loop(w); });
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(state_lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (thread& t : threads) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return (int)workers.size(); }
+
+    void submit(Task task) {
+        int w = currentPool() == this ? currentWorker() : -1;
+        ++pending;
+        {
+            if (w < 0) {
+                lock_guard<mutex> guard(state_lock);
+                w = (int)(next_queue++ % workers.size());
+            }
+            lock_guard<mutex> guard(workers[w]->lock);
+            workers[w]->tasks.push_back(move(task));
+            ++queued;
+        }
+        lock_guard<mutex> guard(state_lock);
+        wake.notify_one();
+    }
+
+    /**
+     * Espera a que terminen todas las tareas enviadas (no llamar desde una tarea)
+     */
+    void wait() {
+        unique_lock<mutex> guard(state_lock);
+        finished.wait(guard, [&] { return pending == 0; });
+        if (first_error) {
+            exception_ptr error = first_error;
+            first_error = nullptr;
+            rethrow_exception(error);
+        }
+    }
+};
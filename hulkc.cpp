@@ -0,0 +1,52 @@
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+
+#include "./core/grammar.cpp"
+#include "./core/automata.cpp"
+#include "./core/reg_exp.cpp"
+#include "./core/lexer.cpp"
+#include "./core/parsers.cpp"
+#include "./core/ast.cpp"
+#include "./core/thread_pool.cpp"
+#include "./core/source_manager.cpp"
+#include "./core/batch.cpp"
+
+
+using namespace std;
+
+// Compila en paralelo archivos .hulk (o todos los de los directorios dados)
+//      hulkc [-j N] <archivo.hulk | directorio>...
+int main(int argc, char const *argv[]) {
+    int n_threads = 0;
+    vector<string> paths;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            n_threads = stoi(argv[++i]);
+        } else if (filesystem::is_directory(arg)) {
+            vector<string> found = BatchCompiler::findSources(arg);
+            paths.insert(paths.end(), found.begin(), found.end());
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.empty()) {
+        cerr << "uso: hulkc [-j N] <archivo.hulk | directorio>...\n";
+        return 2;
+    }
+
+    HulkSyntax syntax = hulkSyntax();
+    Lexer lexer(hulkLexerRules());
+    LL1Parser parser(syntax.grammar);
+    BatchCompiler compiler(syntax, lexer, parser);
+
+    auto start = chrono::steady_clock::now();
+    vector<CompileResult> results = compiler.compile(paths, n_threads);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    size_t failed = BatchCompiler::printDiagnostics(results);
+    cerr << results.size() << " archivos, " << failed << " con errores, " << seconds << " s\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -7,7 +7,16 @@
 
 #include "./core/grammar.cpp"
 #include "./core/automata.cpp"
+#include "./core/reg_exp.cpp"
+#include "./core/lexer.cpp"
 #include "./core/parsers.cpp"
+#include "./core/ast.cpp"
+#include "./core/table_file.cpp"
+#include "./core/codegen.cpp"
+#include "./core/static_grammar.cpp"
+#include "./core/thread_pool.cpp"
+#include "./core/source_manager.cpp"
+#include "./core/batch.cpp"
 
 
 using namespace std;
@@ -15,14 +24,14 @@ using namespace std;
 // Loads all .hulk test files from ./tests/ directory
 vector<pair<string, string>> load_tests() {
     vector<pair<string, string>> tests;
+    SourceManager sources;
     for (const auto& entry : filesystem::directory_iterator("./test/")) {
         if (entry.path().extension() == ".hulk") {
-            ifstream file(entry.path());
-            if (file) {
-                string content((istreambuf_iterator<char>(file)),
-                                istreambuf_iterator<char>());
-                tests.push_back(std::make_pair(entry.path().filename().string(), content));
-            }
+            try {
+                const SourceFile& file = sources.load(entry.path().string());
+                tests.push_back(std::make_pair(entry.path().filename().string(), string(file.getText())));
+                sources.release(file.getId());
+            } catch (const runtime_error&) {}
         }
     }
     return tests;
@@ -106,6 +115,15 @@ LL1Parser parser (Grammar& G) {
 int main(int argc, char const *argv[]) {
     //test1();
     //test_LL1Parser();
+    //test_Regex();
+    //test_SLR1Parser();
+    //test_LALR1Parser();
+    //test_HulkAst();
+    //test_TableFile();
+    //test_Codegen();
+    //test_StaticLL1();
+    //test_BatchCompiler();
+    //test_SourceManager();
     // _parser = parser(G);
     // _parser.parse(tokenizer_result);
     return 0;